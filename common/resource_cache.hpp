@@ -0,0 +1,77 @@
+#pragma once
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+
+// Shared by skilltree and states (both Makefiles add -I../common).
+//
+// Every file is read once and shared by everyone who asks for the same path: N sprites
+// with the same icon use one texture. The cache only keeps weak references, so a resource
+// lives while someone holds it and is read again if it's asked for after that.
+// Resource is anything with loadFromFile(path): sf::Texture, sf::Font, sf::Image...
+template<class Resource>
+class ResourceCache
+{
+public:
+
+    // Returns nullptr if the file can't be loaded
+    std::shared_ptr<const Resource> get(const std::string& path)
+    {
+        std::weak_ptr<const Resource>& cached = mResources[path];
+        if (std::shared_ptr<const Resource> resource = cached.lock())
+            return resource;
+
+        std::shared_ptr<Resource> resource = std::make_shared<Resource>();
+        mLoadCount++;
+        if (!resource->loadFromFile(path))
+        {
+            std::cerr << "Can't load " << path << std::endl;
+            return nullptr;
+        }
+        cached = resource;
+        return resource;
+    }
+
+    // Number of times a file was actually read
+    size_t getLoadCount() const
+    {
+        return mLoadCount;
+    }
+
+    // Number of resources someone still holds
+    size_t getLiveCount() const
+    {
+        size_t count = 0;
+        for (const auto& [path, resource] : mResources)
+        {
+            if (!resource.expired())
+                count++;
+        }
+        return count;
+    }
+
+    // Number of holders of the resource loaded from path, 0 if it isn't loaded
+    long getUseCount(const std::string& path) const
+    {
+        auto it = mResources.find(path);
+        return it == mResources.end() ? 0 : it->second.use_count();
+    }
+
+private:
+
+    std::unordered_map<std::string, std::weak_ptr<const Resource>> mResources {};
+    size_t mLoadCount {0};
+};
+
+
+// One cache per resource type for the whole program. Not thread safe: resources are
+// loaded on the main thread (headless worlds in sim don't load any)
+template<class Resource>
+ResourceCache<Resource>& getResourceCache()
+{
+    static ResourceCache<Resource> cache;
+    return cache;
+}
@@ -4,6 +4,8 @@
 #include <string>
 #include <memory>
 #include "sfline.hpp"
+#include "resource_cache.hpp"
+#include "texture_atlas.hpp"
 #include <iostream>
 #include <vector>
 
@@ -18,6 +20,15 @@ using std::cout, std::endl;
 */
 
 
+// What a skill tree sent to the window in the last frame
+struct DrawStats
+{
+    size_t drawCalls            {0};
+    size_t texturedDrawCalls    {0};    // icons and text; every draw with a texture can rebind it
+    size_t icons                {0};
+};
+
+
 class Node
 {
 public:
@@ -94,10 +105,28 @@ public:
         }
         return pointsChange;
     }
-    virtual void draw(sf::RenderWindow& window) const = 0;
+    // Draws the node and its children; icons go to the batch instead, the caller draws
+    // them all at once with the atlas texture
+    virtual void draw(sf::RenderWindow& window, sf::VertexArray& icons, DrawStats& stats) const = 0;
+
+    // Every icon file of this directory is packed into one atlas
+    inline static const std::string kIconDirectory {"icons"};
 
 protected:
 
+    // Two triangles showing rect of the atlas with its top left corner at position
+    static void appendIcon(sf::VertexArray& icons, sf::Vector2f position, const sf::IntRect& rect, DrawStats& stats)
+    {
+        stats.icons++;
+        sf::Vector2f size(rect.width, rect.height);
+        sf::Vector2f corners[4] {{0, 0}, {size.x, 0}, {size.x, size.y}, {0, size.y}};
+        for (int i : {0, 1, 2, 0, 2, 3})
+        {
+            sf::Vector2f texCoords = sf::Vector2f(rect.left, rect.top) + corners[i];
+            icons.append(sf::Vertex(position + corners[i], texCoords));
+        }
+    }
+
     sf::Vector2f mPosition {0, 0};
     State mState = State::Blocked;
 
@@ -120,17 +149,16 @@ public:
 
     virtual sf::String getIconPath() = 0;
 
-    void loadTexture()
+    void loadIcon()
     {
-        sf::String texturePath = getIconPath();
-        if (!mTexture.loadFromFile(texturePath))
+        std::string iconPath = getIconPath().toAnsiString();
+        mpIcons = getResourceCache<TextureAtlas>().get(kIconDirectory);
+        if (!mpIcons || !mpIcons->contains(iconPath))
         {
-            cout << "Error! Can't load file " << texturePath.toAnsiString() << endl;
+            cout << "Error! Can't load file " << iconPath << endl;
             std::exit(1);
         }
-        mSprite.setTexture(mTexture);
-        mSprite.setOrigin({mRadius, mRadius});
-        mSprite.setPosition(mPosition);
+        mIconRect = mpIcons->getRect(iconPath);
     }
 
 
@@ -143,13 +171,14 @@ public:
         return sBlockedColor;
     }
 
-    void draw(sf::RenderWindow& window) const override
+    void draw(sf::RenderWindow& window, sf::VertexArray& icons, DrawStats& stats) const override
     {
         for (const auto& el : mChildren)
         {
             sfLine connectionLine {mPosition, el->getPosition(), getCurrentColor(), 2};
             connectionLine.draw(window);
-            el->draw(window);
+            stats.drawCalls++;
+            el->draw(window, icons, stats);
         }
 
         static sf::CircleShape shape(mRadius);
@@ -157,8 +186,9 @@ public:
         shape.setFillColor(getCurrentColor());
         shape.setPosition(mPosition);
         window.draw(shape);
+        stats.drawCalls++;
 
-        window.draw(mSprite);
+        appendIcon(icons, mPosition - sf::Vector2f(mRadius, mRadius), mIconRect, stats);
     }
 
     bool collisionTest(sf::Vector2f mouseCoords) override
@@ -169,8 +199,9 @@ public:
 
 private:
 
-    sf::Texture mTexture;
-    sf::Sprite mSprite;
+    // all nodes share one atlas
+    std::shared_ptr<const TextureAtlas> mpIcons;
+    sf::IntRect mIconRect;
 
     float mRadius = 24;
     bool mIsActivated = false;
@@ -187,17 +218,16 @@ public:
 
     virtual sf::String getIconPath() = 0;
 
-    void loadTexture()
+    void loadIcon()
     {
-        sf::String texturePath = getIconPath();
-        if (!mTexture.loadFromFile(texturePath))
+        std::string iconPath = getIconPath().toAnsiString();
+        mpIcons = getResourceCache<TextureAtlas>().get(kIconDirectory);
+        if (!mpIcons || !mpIcons->contains(iconPath))
         {
-            cout << "Error! Can't load file " << texturePath.toAnsiString() << endl;
+            cout << "Error! Can't load file " << iconPath << endl;
             std::exit(1);
         }
-        mSprite.setTexture(mTexture);
-        mSprite.setOrigin({mRadius, mRadius});
-        mSprite.setPosition(mPosition);
+        mIconRect = mpIcons->getRect(iconPath);
     }
 
     sf::Color getCurrentColor() const
@@ -275,13 +305,14 @@ public:
         return pointsChange;
     }
 
-    void draw(sf::RenderWindow& window) const override
+    void draw(sf::RenderWindow& window, sf::VertexArray& icons, DrawStats& stats) const override
     {
         for (const auto& el : mChildren)
         {
             sfLine connectionLine {mPosition, el->getPosition(), getCurrentColor(), 2};
             connectionLine.draw(window);
-            el->draw(window);
+            stats.drawCalls++;
+            el->draw(window, icons, stats);
         }
 
         static sf::RectangleShape shape;
@@ -290,19 +321,20 @@ public:
         shape.setFillColor(getCurrentColor());
         shape.setPosition(mPosition - sf::Vector2f(mRadius + 1, mRadius + 1));
         window.draw(shape);
+        stats.drawCalls++;
 
-        window.draw(mSprite);
-        if (mState != State::Blocked)
+        appendIcon(icons, mPosition - sf::Vector2f(mRadius, mRadius), mIconRect, stats);
+        if (mState != State::Blocked && mpFont)
         {
-            sf::Font font;
-            font.loadFromFile("HelveticaRegular.ttf");
             sf::Text currentPointsText;
-            currentPointsText.setFont(font);
+            currentPointsText.setFont(*mpFont);
             currentPointsText.setString(std::to_string(mCurrentPoints) + "/" + std::to_string(mMaxPoints));
             currentPointsText.setPosition(mPosition + sf::Vector2f(-currentPointsText.getLocalBounds().width / 2 + 4, mRadius + 3));
             currentPointsText.setFillColor(sf::Color::White);
             currentPointsText.setCharacterSize(24);
             window.draw(currentPointsText);
+            stats.drawCalls++;
+            stats.texturedDrawCalls++;
         }
     }
 
@@ -312,8 +344,11 @@ public:
         return -mRadius - 1 < d.x && d.x < mRadius + 1 && -mRadius - 1 < d.y && d.y < mRadius + 1;
     }
 private:
-    sf::Texture mTexture;
-    sf::Sprite mSprite;
+    // all nodes share one atlas
+    std::shared_ptr<const TextureAtlas> mpIcons;
+    sf::IntRect mIconRect;
+
+    std::shared_ptr<const sf::Font> mpFont {getResourceCache<sf::Font>().get("HelveticaRegular.ttf")};
 
     inline static sf::Color sPartlyActivatedColor {140, 140, 40};
 
@@ -332,7 +367,7 @@ class BombSkillNode : public HitNode
 public:
     BombSkillNode(sf::Vector2f position) : HitNode{position} 
     {
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -346,7 +381,7 @@ class SpikesSkillNode : public HitNode
 public:
     SpikesSkillNode(sf::Vector2f position) : HitNode{position} 
     {
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -361,7 +396,7 @@ class LightningSkillNode : public HitNode
 public:
     LightningSkillNode(sf::Vector2f position) : HitNode{position} 
     {
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -376,7 +411,7 @@ class EyeSkillNode : public HitNode
 public:
     EyeSkillNode(sf::Vector2f position) : HitNode{position} 
     {
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -391,7 +426,7 @@ class ClawsSkillNode : public HitNode
 public:
     ClawsSkillNode(sf::Vector2f position) : HitNode{position} 
     {
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -405,7 +440,7 @@ class ShieldSkillNode : public HitNode
 public:
     ShieldSkillNode(sf::Vector2f position) : HitNode{position} 
     {
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -420,7 +455,7 @@ class SwordSkillNode : public HitNode
 public:
     SwordSkillNode(sf::Vector2f position) : HitNode{position} 
     {
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -435,7 +470,7 @@ class ShurikenSkillNode : public HitNode
 public:
     ShurikenSkillNode(sf::Vector2f position) : HitNode{position} 
     {
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -449,7 +484,7 @@ class WindSkillNode : public HitNode
 public:
     WindSkillNode(sf::Vector2f position) : HitNode{position} 
     {
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -464,7 +499,7 @@ class MeteoriteSkillNode : public HitNode
 public:
     MeteoriteSkillNode(sf::Vector2f position) : HitNode{position} 
     {
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -478,7 +513,7 @@ class HandSkillNode : public HitNode
 public:
     HandSkillNode(sf::Vector2f position) : HitNode{position} 
     {
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -492,7 +527,7 @@ class EarthquakeSkillNode : public HitNode
 public:
     EarthquakeSkillNode(sf::Vector2f position) : HitNode{position} 
     {
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -506,7 +541,7 @@ class FireballSkillNode : public HitNode
 public:
     FireballSkillNode(sf::Vector2f position) : HitNode{position} 
     {
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -521,7 +556,7 @@ public:
     ChainAccumulativeSkillNode(sf::Vector2f position) : AccumulativeNode{position}
     {
         setMaxPoints(6);
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -536,7 +571,7 @@ public:
     SwordAccumulativeSkillNode(sf::Vector2f position) : AccumulativeNode{position}
     {
         setMaxPoints(5);
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -551,7 +586,7 @@ public:
     FreezeAccumulativeSkillNode(sf::Vector2f position) : AccumulativeNode{position}
     {
         setMaxPoints(7);
-        loadTexture();
+        loadIcon();
     }
 
     sf::String getIconPath() override
@@ -577,12 +612,22 @@ public:
     }
     virtual void draw(sf::RenderWindow& window)
     {
-        mRootNode->draw(window);
-        sf::Font font;
-        font.loadFromFile("HelveticaRegular.ttf");
+        // every icon of the tree goes in one draw call with one texture
+        mDrawStats = DrawStats{};
+        mIcons.clear();
+        mRootNode->draw(window, mIcons, mDrawStats);
+        if (mpIcons)
+        {
+            window.draw(mIcons, &mpIcons->getTexture());
+            mDrawStats.drawCalls++;
+            mDrawStats.texturedDrawCalls++;
+        }
+
+        if (!mpFont)
+            return;
 
         sf::Text scoreText;
-        scoreText.setFont(font);
+        scoreText.setFont(*mpFont);
         scoreText.setString(std::to_string(mCurrentPoints));
         scoreText.setPosition(sf::Vector2f(mRootXPosition - scoreText.getLocalBounds().width / 2 - 5, 530));
         scoreText.setFillColor(sf::Color::White);
@@ -590,16 +635,27 @@ public:
         window.draw(scoreText);
 
          sf::Text classNameText;
-        classNameText.setFont(font);
+        classNameText.setFont(*mpFont);
         classNameText.setString(mClassName);
         classNameText.setPosition(sf::Vector2f(mRootXPosition - classNameText.getLocalBounds().width / 2 - 5, 600));
         classNameText.setFillColor(sf::Color::White);
         classNameText.setCharacterSize(40);
         window.draw(classNameText);
+        mDrawStats.drawCalls += 2;
+        mDrawStats.texturedDrawCalls += 2;
+    }
+
+    const DrawStats& getDrawStats() const
+    {
+        return mDrawStats;
     }
 private:
     int mCurrentPoints = 0;
     std::string mClassName = "";
+    std::shared_ptr<const sf::Font> mpFont {getResourceCache<sf::Font>().get("HelveticaRegular.ttf")};
+    std::shared_ptr<const TextureAtlas> mpIcons {getResourceCache<TextureAtlas>().get(Node::kIconDirectory)};
+    sf::VertexArray mIcons {sf::Triangles};
+    DrawStats mDrawStats;
 protected:
     std::shared_ptr<Node> mRootNode;
     float mRootXPosition;
@@ -684,11 +740,18 @@ int main()
     sf::RenderWindow window(sf::VideoMode(1200, 800), "Skill Tree", sf::Style::Close, settings);
     window.setFramerateLimit(60);
 
+    sf::Clock startupClock;
     std::vector<std::shared_ptr<SkillTree>> skillTrees {
         std::make_shared<MageSkillTree>(400),
         std::make_shared<WarriorSkillTree>(700),
         std::make_shared<RogueSkillTree>(1000)
     };
+    cout << "Skill trees built in " << startupClock.getElapsedTime().asMicroseconds() / 1000.0 << " ms: "
+         << getResourceCache<TextureAtlas>().getLoadCount() << " icon atlas and "
+         << getResourceCache<sf::Font>().getLoadCount() << " fonts read from disk" << endl;
+
+    // draw stats are printed for the first frame and after every click
+    bool isStatsOutdated = true;
 
     while (window.isOpen())
     {
@@ -704,6 +767,7 @@ int main()
                 sf::Vector2f mouseCoords = window.mapPixelToCoords({event.mouseButton.x, event.mouseButton.y});
                 for (const auto& skillTree : skillTrees)
                     skillTree->onMousePressed(mouseCoords, event.mouseButton.button);
+                isStatsOutdated = true;
             }
         }
 
@@ -712,6 +776,20 @@ int main()
         for (const auto& skillTree : skillTrees)
             skillTree->draw(window);
         window.display();
+
+        if (isStatsOutdated)
+        {
+            DrawStats total;
+            for (const auto& skillTree : skillTrees)
+            {
+                total.drawCalls += skillTree->getDrawStats().drawCalls;
+                total.texturedDrawCalls += skillTree->getDrawStats().texturedDrawCalls;
+                total.icons += skillTree->getDrawStats().icons;
+            }
+            cout << "Frame: " << total.drawCalls << " draw calls, " << total.texturedDrawCalls
+                 << " of them textured, " << total.icons << " icons" << endl;
+            isStatsOutdated = false;
+        }
     }
 
     return 0;
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// Every image of a directory packed into one texture at startup, so everything drawn
+// from them can go in a single batched draw. getRect(path) gives the image's place in
+// the texture, path being directory + "/" + file name, e.g. "icons/icon_bomb.png".
+// Has loadFromFile(directory), so it can live in ResourceCache like a texture.
+class TextureAtlas
+{
+public:
+
+    bool loadFromFile(const std::string& directory)
+    {
+        std::vector<std::string> paths;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+        {
+            if (entry.path().extension() == ".png")
+                paths.push_back(directory + "/" + entry.path().filename().string());
+        }
+        if (error)
+        {
+            std::cerr << "Can't read directory " << directory << std::endl;
+            return false;
+        }
+        return loadFromFiles(paths);
+    }
+
+    bool loadFromFiles(std::vector<std::string> paths)
+    {
+        // the same files always give the same atlas
+        std::sort(paths.begin(), paths.end());
+        std::vector<sf::Image> images(paths.size());
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            if (!images[i].loadFromFile(paths[i]))
+            {
+                std::cerr << "Can't load " << paths[i] << std::endl;
+                return false;
+            }
+        }
+
+        // Shelf packing: tallest images first, left to right in rows as wide as a square
+        // of the same area would be. kPadding keeps neighbours from bleeding into each other.
+        std::vector<size_t> order(paths.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+        {
+            return images[a].getSize().y > images[b].getSize().y;
+        });
+
+        unsigned int area = 0;
+        unsigned int width = 0;
+        for (const sf::Image& image : images)
+        {
+            area += (image.getSize().x + kPadding) * (image.getSize().y + kPadding);
+            width = std::max(width, image.getSize().x + kPadding);
+        }
+        width = std::max(width, static_cast<unsigned int>(std::ceil(std::sqrt(area))));
+
+        mRects.clear();
+        unsigned int x = 0;
+        unsigned int y = 0;
+        unsigned int shelfHeight = 0;
+        for (size_t i : order)
+        {
+            sf::Vector2u size = images[i].getSize();
+            if (x + size.x > width)
+            {
+                x = 0;
+                y += shelfHeight + kPadding;
+                shelfHeight = 0;
+            }
+            mRects[paths[i]] = sf::IntRect(x, y, size.x, size.y);
+            x += size.x + kPadding;
+            shelfHeight = std::max(shelfHeight, size.y);
+        }
+
+        sf::Image atlas;
+        atlas.create(width, y + shelfHeight, sf::Color::Transparent);
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            const sf::IntRect& rect = mRects[paths[i]];
+            atlas.copy(images[i], rect.left, rect.top);
+        }
+        return mTexture.loadFromImage(atlas);
+    }
+
+    const sf::Texture& getTexture() const
+    {
+        return mTexture;
+    }
+
+    bool contains(const std::string& path) const
+    {
+        return mRects.find(path) != mRects.end();
+    }
+
+    // Empty rect if path isn't in the atlas
+    sf::IntRect getRect(const std::string& path) const
+    {
+        auto it = mRects.find(path);
+        return it == mRects.end() ? sf::IntRect{} : it->second;
+    }
+
+    size_t size() const
+    {
+        return mRects.size();
+    }
+
+private:
+
+    static constexpr unsigned int kPadding = 1;
+
+    sf::Texture mTexture {};
+    std::unordered_map<std::string, sf::IntRect> mRects {};
+};
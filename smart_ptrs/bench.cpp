@@ -0,0 +1,691 @@
+// Benchmarks of my_* smart pointers against their std counterparts.
+//
+//     make run                          - human readable table
+//     ./bench --format=csv > out.csv    - one line per case, for tracking between releases
+//     ./bench --format=json --filter=copy/
+//
+// Every case reports ns/op and heap allocations and bytes per op (counted by the
+// operator new replacement below); growth cases also count element copies and moves,
+// churn cases are run in a child process and additionally report how much their peak RSS grew.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "my_shared_ptr.hpp"
+#include "my_weak_ptr.hpp"
+#include "my_intrusive_ptr.hpp"
+#include "my_unique_ptr.hpp"
+#include "my_pool_allocator.hpp"
+#include "my_small_vector.hpp"
+
+
+static std::atomic<std::size_t> gAllocs {0};
+static std::atomic<std::size_t> gBytes {0};
+static std::size_t gCopies = 0;
+static std::size_t gMoves = 0;
+
+static void* countedAlloc(std::size_t size, std::size_t align) {
+	gAllocs.fetch_add(1, std::memory_order_relaxed);
+	gBytes.fetch_add(size, std::memory_order_relaxed);
+	void* p = align <= alignof(std::max_align_t) ? std::malloc(size) : std::aligned_alloc(align, (size + align - 1) / align * align);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size, 0); }
+void* operator new[](std::size_t size) { return countedAlloc(size, 0); }
+void* operator new(std::size_t size, std::align_val_t align) { return countedAlloc(size, std::size_t(align)); }
+void* operator new[](std::size_t size, std::align_val_t align) { return countedAlloc(size, std::size_t(align)); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+
+template<class T>
+static void doNotOptimize(const T& value) {
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+static long peakRssKb() {
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+
+struct Result {
+	std::string name;
+	std::size_t ops;
+	double nsPerOp;
+	double allocsPerOp;
+	double bytesPerOp;
+	double copiesPerOp;
+	double movesPerOp;
+	long peakRssKb;     // growth of peak RSS, -1 when not measured
+};
+
+struct Options {
+	std::string format = "table";
+	std::string filter = "";
+	double scale = 1;
+};
+
+static Options gOptions;
+static std::vector<Result> gResults;
+
+
+static Result measure(const std::string& name, std::size_t ops, const std::function<void()>& body) {
+	std::size_t allocs = gAllocs.load();
+	std::size_t bytes = gBytes.load();
+	std::size_t copies = gCopies;
+	std::size_t moves = gMoves;
+	auto start = std::chrono::steady_clock::now();
+	body();
+	auto end = std::chrono::steady_clock::now();
+
+	Result r;
+	r.name = name;
+	r.ops = ops;
+	r.nsPerOp = std::chrono::duration<double, std::nano>(end - start).count() / ops;
+	r.allocsPerOp = double(gAllocs.load() - allocs) / ops;
+	r.bytesPerOp = double(gBytes.load() - bytes) / ops;
+	r.copiesPerOp = double(gCopies - copies) / ops;
+	r.movesPerOp = double(gMoves - moves) / ops;
+	r.peakRssKb = -1;
+	return r;
+}
+
+static bool selected(const std::string& name) {
+	return gOptions.filter.empty() || name.find(gOptions.filter) != std::string::npos;
+}
+
+static std::size_t scaled(std::size_t ops) {
+	return std::max<std::size_t>(1, std::size_t(ops * gOptions.scale));
+}
+
+// body gets the number of operations it has to perform
+static void bench(const std::string& name, std::size_t ops, const std::function<void(std::size_t)>& body) {
+	if (!selected(name))
+		return;
+	ops = scaled(ops);
+	gResults.push_back(measure(name, ops, [&] { body(ops); }));
+}
+
+// Same, but in a forked child so that the peak RSS belongs to this case alone
+static void benchIsolated(const std::string& name, std::size_t ops, const std::function<void(std::size_t)>& body) {
+	if (!selected(name))
+		return;
+	ops = scaled(ops);
+
+	int fds[2];
+	if (pipe(fds) != 0) {
+		std::perror("pipe");
+		std::exit(1);
+	}
+	pid_t pid = fork();
+	if (pid == 0) {
+		close(fds[0]);
+		long rssBefore = peakRssKb();
+		Result r = measure(name, ops, [&] { body(ops); });
+		double out[6] = {r.nsPerOp, r.allocsPerOp, r.bytesPerOp, r.copiesPerOp, r.movesPerOp, double(peakRssKb() - rssBefore)};
+		ssize_t written = write(fds[1], out, sizeof(out));
+		_exit(written == sizeof(out) ? 0 : 1);
+	}
+	close(fds[1]);
+	double in[6] = {0, 0, 0, 0, 0, -1};
+	ssize_t got = read(fds[0], in, sizeof(in));
+	close(fds[0]);
+	waitpid(pid, nullptr, 0);
+	if (got != sizeof(in)) {
+		std::fprintf(stderr, "%s: child failed\n", name.c_str());
+		return;
+	}
+	gResults.push_back({name, ops, in[0], in[1], in[2], in[3], in[4], long(in[5])});
+}
+
+
+struct Payload {
+	int value;
+	explicit Payload(int value = 0) : value(value) { }
+};
+
+struct RefPayload : my_ref_counted<RefPayload> {
+	int value;
+	explicit RefPayload(int value = 0) : value(value) { }
+};
+
+struct LocalRefPayload : my_ref_counted<LocalRefPayload, my_lock_policy::single> {
+	int value;
+	explicit LocalRefPayload(int value = 0) : value(value) { }
+};
+
+
+static void constructionCases() {
+	const std::size_t n = 2000000;
+
+	bench("construct/raw_new", n, [](std::size_t ops) {
+		for (std::size_t i = 0; i < ops; i++) {
+			Payload* p = new Payload(int(i));
+			doNotOptimize(p);
+			delete p;
+		}
+	});
+	bench("construct/my_shared_ptr_new", n, [](std::size_t ops) {
+		for (std::size_t i = 0; i < ops; i++) {
+			my_shared_ptr<Payload> p(new Payload(int(i)));
+			doNotOptimize(p.get());
+		}
+	});
+	bench("construct/my_make_shared", n, [](std::size_t ops) {
+		for (std::size_t i = 0; i < ops; i++) {
+			auto p = my_make_shared<Payload>(int(i));
+			doNotOptimize(p.get());
+		}
+	});
+	bench("construct/my_allocate_shared_pool", n, [](std::size_t ops) {
+		for (std::size_t i = 0; i < ops; i++) {
+			auto p = my_allocate_shared<Payload>(my_pool_allocator<Payload>(), int(i));
+			doNotOptimize(p.get());
+		}
+	});
+	// the count lives in the object, so there is no second allocation for a block
+	bench("construct/my_intrusive_ptr", n, [](std::size_t ops) {
+		for (std::size_t i = 0; i < ops; i++) {
+			my_intrusive_ptr<RefPayload> p(new RefPayload(int(i)));
+			doNotOptimize(p.get());
+		}
+	});
+	bench("construct/std_shared_ptr_new", n, [](std::size_t ops) {
+		for (std::size_t i = 0; i < ops; i++) {
+			std::shared_ptr<Payload> p(new Payload(int(i)));
+			doNotOptimize(p.get());
+		}
+	});
+	bench("construct/std_make_shared", n, [](std::size_t ops) {
+		for (std::size_t i = 0; i < ops; i++) {
+			auto p = std::make_shared<Payload>(int(i));
+			doNotOptimize(p.get());
+		}
+	});
+	bench("construct/my_shared_ptr_default", n, [](std::size_t ops) {
+		for (std::size_t i = 0; i < ops; i++) {
+			my_shared_ptr<Payload> p;
+			doNotOptimize(p.get());
+		}
+	});
+	bench("construct/my_unique_ptr", n, [](std::size_t ops) {
+		for (std::size_t i = 0; i < ops; i++) {
+			my_unique_ptr<Payload> p(new Payload(int(i)));
+			doNotOptimize(p.get());
+		}
+	});
+	bench("construct/std_unique_ptr", n, [](std::size_t ops) {
+		for (std::size_t i = 0; i < ops; i++) {
+			std::unique_ptr<Payload> p(new Payload(int(i)));
+			doNotOptimize(p.get());
+		}
+	});
+}
+
+
+template<class Ptr>
+static void copyLoop(const Ptr& source, std::size_t ops) {
+	for (std::size_t i = 0; i < ops; i++) {
+		Ptr copy(source);
+		doNotOptimize(copy.get());
+	}
+}
+
+static void copyCases() {
+	const std::size_t n = 20000000;
+
+	bench("copy/my_shared_ptr_atomic", n, [](std::size_t ops) {
+		copyLoop(my_make_shared<Payload>(1), ops);
+	});
+	bench("copy/my_shared_ptr_single", n, [](std::size_t ops) {
+		copyLoop(my_make_shared<Payload, my_lock_policy::single>(1), ops);
+	});
+	bench("copy/std_shared_ptr", n, [](std::size_t ops) {
+		copyLoop(std::make_shared<Payload>(1), ops);
+	});
+	bench("copy/my_intrusive_ptr_atomic", n, [](std::size_t ops) {
+		copyLoop(my_intrusive_ptr<RefPayload>(new RefPayload(1)), ops);
+	});
+	bench("copy/my_intrusive_ptr_single", n, [](std::size_t ops) {
+		copyLoop(my_intrusive_ptr<LocalRefPayload>(new LocalRefPayload(1)), ops);
+	});
+	bench("copy/my_weak_ptr_lock", n, [](std::size_t ops) {
+		auto owner = my_make_shared<Payload>(1);
+		my_weak_ptr<Payload> weak(owner);
+		for (std::size_t i = 0; i < ops; i++)
+			doNotOptimize(weak.lock().get());
+	});
+	bench("copy/std_weak_ptr_lock", n, [](std::size_t ops) {
+		auto owner = std::make_shared<Payload>(1);
+		std::weak_ptr<Payload> weak(owner);
+		for (std::size_t i = 0; i < ops; i++)
+			doNotOptimize(weak.lock().get());
+	});
+}
+
+
+template<class Ptr>
+static void moveLoop(Ptr ptr, std::size_t ops) {
+	for (std::size_t i = 0; i < ops; i++) {
+		Ptr other(std::move(ptr));
+		ptr = std::move(other);
+		doNotOptimize(ptr.get());
+	}
+}
+
+static void moveCases() {
+	const std::size_t n = 20000000;
+
+	bench("move/my_shared_ptr", n, [](std::size_t ops) {
+		moveLoop(my_make_shared<Payload>(1), ops);
+	});
+	bench("move/std_shared_ptr", n, [](std::size_t ops) {
+		moveLoop(std::make_shared<Payload>(1), ops);
+	});
+	bench("move/my_unique_ptr", n, [](std::size_t ops) {
+		moveLoop(my_unique_ptr<Payload>(new Payload(1)), ops);
+	});
+	bench("move/std_unique_ptr", n, [](std::size_t ops) {
+		moveLoop(std::unique_ptr<Payload>(new Payload(1)), ops);
+	});
+}
+
+
+template<class Ptr>
+static void derefLoop(const std::vector<Ptr>& ptrs, std::size_t ops) {
+	long sum = 0;
+	for (std::size_t i = 0; i < ops; i++)
+		sum += ptrs[i % ptrs.size()]->value;
+	doNotOptimize(sum);
+}
+
+static void dereferenceCases() {
+	const std::size_t n = 50000000;
+	const std::size_t count = 1024;
+
+	bench("deref/raw", n, [&](std::size_t ops) {
+		std::vector<Payload> objects(count);
+		std::vector<Payload*> ptrs;
+		for (Payload& p : objects)
+			ptrs.push_back(&p);
+		derefLoop(ptrs, ops);
+	});
+	bench("deref/my_unique_ptr", n, [&](std::size_t ops) {
+		std::vector<my_unique_ptr<Payload>> ptrs;
+		for (std::size_t i = 0; i < count; i++)
+			ptrs.push_back(my_unique_ptr<Payload>(new Payload(int(i))));
+		derefLoop(ptrs, ops);
+	});
+	bench("deref/std_unique_ptr", n, [&](std::size_t ops) {
+		std::vector<std::unique_ptr<Payload>> ptrs;
+		for (std::size_t i = 0; i < count; i++)
+			ptrs.push_back(std::unique_ptr<Payload>(new Payload(int(i))));
+		derefLoop(ptrs, ops);
+	});
+	bench("deref/my_shared_ptr", n, [&](std::size_t ops) {
+		std::vector<my_shared_ptr<Payload>> ptrs;
+		for (std::size_t i = 0; i < count; i++)
+			ptrs.push_back(my_make_shared<Payload>(int(i)));
+		derefLoop(ptrs, ops);
+	});
+	bench("deref/std_shared_ptr", n, [&](std::size_t ops) {
+		std::vector<std::shared_ptr<Payload>> ptrs;
+		for (std::size_t i = 0; i < count; i++)
+			ptrs.push_back(std::make_shared<Payload>(int(i)));
+		derefLoop(ptrs, ops);
+	});
+}
+
+
+// Copies every pointer of a large shuffled set once, so the counters are touched in
+// random order: a separate block for my_shared_ptr(new T), the object itself for
+// my_intrusive_ptr. Only time is measured here, cache misses are not counted.
+template<class Ptr>
+static void shuffledCopyLoop(std::vector<Ptr> ptrs, std::size_t ops) {
+	std::shuffle(ptrs.begin(), ptrs.end(), std::mt19937(42));
+	std::size_t done = 0;
+	while (done < ops) {
+		for (std::size_t i = 0; i < ptrs.size() && done < ops; i++, done++) {
+			Ptr copy(ptrs[i]);
+			doNotOptimize(copy.get());
+		}
+	}
+}
+
+static void shuffledCopyCases() {
+	const std::size_t n = 1 << 20;
+
+	bench("shuffled_copy/my_shared_ptr_new", n, [](std::size_t ops) {
+		std::vector<my_shared_ptr<Payload>> ptrs;
+		for (std::size_t i = 0; i < ops; i++)
+			ptrs.push_back(my_shared_ptr<Payload>(new Payload(int(i))));
+		shuffledCopyLoop(std::move(ptrs), ops);
+	});
+	bench("shuffled_copy/my_make_shared", n, [](std::size_t ops) {
+		std::vector<my_shared_ptr<Payload>> ptrs;
+		for (std::size_t i = 0; i < ops; i++)
+			ptrs.push_back(my_make_shared<Payload>(int(i)));
+		shuffledCopyLoop(std::move(ptrs), ops);
+	});
+	bench("shuffled_copy/my_intrusive_ptr", n, [](std::size_t ops) {
+		std::vector<my_intrusive_ptr<RefPayload>> ptrs;
+		for (std::size_t i = 0; i < ops; i++)
+			ptrs.push_back(my_intrusive_ptr<RefPayload>(new RefPayload(int(i))));
+		shuffledCopyLoop(std::move(ptrs), ops);
+	});
+	bench("shuffled_copy/std_shared_ptr_new", n, [](std::size_t ops) {
+		std::vector<std::shared_ptr<Payload>> ptrs;
+		for (std::size_t i = 0; i < ops; i++)
+			ptrs.push_back(std::shared_ptr<Payload>(new Payload(int(i))));
+		shuffledCopyLoop(std::move(ptrs), ops);
+	});
+}
+
+
+template<class Ptr, class Make>
+static void sortLoop(std::size_t ops, Make make) {
+	std::mt19937 random(7);
+	std::vector<Ptr> ptrs;
+	ptrs.reserve(ops);
+	for (std::size_t i = 0; i < ops; i++)
+		ptrs.push_back(make(int(random())));
+	std::sort(ptrs.begin(), ptrs.end(), [](const Ptr& a, const Ptr& b) { return a->value < b->value; });
+	doNotOptimize(ptrs.front()->value);
+}
+
+static void sortCases() {
+	const std::size_t n = 1000000;
+
+	bench("sort/raw", n, [](std::size_t ops) {
+		std::vector<Payload> storage(ops);
+		std::size_t next = 0;
+		sortLoop<Payload*>(ops, [&](int v) { storage[next].value = v; return &storage[next++]; });
+	});
+	bench("sort/my_unique_ptr", n, [](std::size_t ops) {
+		sortLoop<my_unique_ptr<Payload>>(ops, [](int v) { return my_unique_ptr<Payload>(new Payload(v)); });
+	});
+	bench("sort/std_unique_ptr", n, [](std::size_t ops) {
+		sortLoop<std::unique_ptr<Payload>>(ops, [](int v) { return std::unique_ptr<Payload>(new Payload(v)); });
+	});
+	bench("sort/my_shared_ptr", n, [](std::size_t ops) {
+		sortLoop<my_shared_ptr<Payload>>(ops, [](int v) { return my_make_shared<Payload>(v); });
+	});
+	bench("sort/std_shared_ptr", n, [](std::size_t ops) {
+		sortLoop<std::shared_ptr<Payload>>(ops, [](int v) { return std::make_shared<Payload>(v); });
+	});
+}
+
+
+// All threads copy and destroy owners of one shared object, the worst case for the counter
+template<class Ptr>
+static void threadedCopyLoop(const Ptr& source, std::size_t ops) {
+	unsigned threadCount = std::max(2u, std::thread::hardware_concurrency());
+	std::vector<std::thread> threads;
+	for (unsigned t = 0; t < threadCount; t++) {
+		threads.emplace_back([&source, ops, threadCount] {
+			for (std::size_t i = 0; i < ops / threadCount; i++) {
+				Ptr copy(source);
+				doNotOptimize(copy.get());
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+// Every thread copies its own object, all made one after another so their blocks are neighbours
+// in memory. Without padding the counts of several threads can share a cache line.
+template<class Make>
+static void threadedNeighbourLoop(std::size_t ops, Make make) {
+	unsigned threadCount = std::max(2u, std::thread::hardware_concurrency());
+	std::vector<decltype(make(0))> sources;
+	for (unsigned t = 0; t < threadCount; t++)
+		sources.push_back(make(int(t)));
+	std::vector<std::thread> threads;
+	for (unsigned t = 0; t < threadCount; t++) {
+		threads.emplace_back([&source = sources[t], ops, threadCount] {
+			for (std::size_t i = 0; i < ops / threadCount; i++) {
+				auto copy(source);
+				doNotOptimize(copy.get());
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+static void threadedCases() {
+	const std::size_t n = 20000000;
+
+	bench("mt_copy/my_shared_ptr", n, [](std::size_t ops) {
+		threadedCopyLoop(my_make_shared<Payload>(1), ops);
+	});
+	bench("mt_copy/std_shared_ptr", n, [](std::size_t ops) {
+		threadedCopyLoop(std::make_shared<Payload>(1), ops);
+	});
+	bench("mt_copy/my_intrusive_ptr", n, [](std::size_t ops) {
+		threadedCopyLoop(my_intrusive_ptr<RefPayload>(new RefPayload(1)), ops);
+	});
+	bench("mt_neighbours/my_make_shared", n, [](std::size_t ops) {
+		threadedNeighbourLoop(ops, [](int v) { return my_make_shared<Payload>(v); });
+	});
+	bench("mt_neighbours/my_make_shared_padded", n, [](std::size_t ops) {
+		threadedNeighbourLoop(ops, [](int v) { return my_make_shared_padded<Payload>(v); });
+	});
+}
+
+
+// Bursts of short-lived pointers: a window of live owners is kept and recycled
+template<class Ptr, class Make>
+static void churnLoop(std::size_t ops, Make make) {
+	const std::size_t window = 1 << 16;
+	std::vector<Ptr> live(window);
+	for (std::size_t i = 0; i < ops; i++)
+		live[i % window] = make(int(i));
+	doNotOptimize(live[0].get());
+}
+
+static void churnCases() {
+	const std::size_t n = 10000000;
+
+	benchIsolated("churn/my_shared_ptr_new", n, [](std::size_t ops) {
+		churnLoop<my_shared_ptr<Payload>>(ops, [](int v) { return my_shared_ptr<Payload>(new Payload(v)); });
+	});
+	benchIsolated("churn/my_make_shared", n, [](std::size_t ops) {
+		churnLoop<my_shared_ptr<Payload>>(ops, [](int v) { return my_make_shared<Payload>(v); });
+	});
+	benchIsolated("churn/my_allocate_shared_pool", n, [](std::size_t ops) {
+		churnLoop<my_shared_ptr<Payload>>(ops, [](int v) { return my_allocate_shared<Payload>(my_pool_allocator<Payload>(), v); });
+	});
+	benchIsolated("churn/std_make_shared", n, [](std::size_t ops) {
+		churnLoop<std::shared_ptr<Payload>>(ops, [](int v) { return std::make_shared<Payload>(v); });
+	});
+}
+
+
+static void bufferCases() {
+	const std::size_t n = 200;
+	const std::size_t floats = 4 << 20;
+
+	bench("buffer/my_make_unique_16MB", n, [&](std::size_t ops) {
+		for (std::size_t i = 0; i < ops; i++) {
+			auto buffer = my_make_unique<float[]>(floats);
+			buffer[i % floats] = 1;
+			doNotOptimize(buffer.get());
+		}
+	});
+	bench("buffer/my_make_unique_for_overwrite_16MB", n, [&](std::size_t ops) {
+		for (std::size_t i = 0; i < ops; i++) {
+			auto buffer = my_make_unique_for_overwrite<float[]>(floats);
+			buffer[i % floats] = 1;
+			doNotOptimize(buffer.get());
+		}
+	});
+}
+
+
+// Handing out pointers to members of one owner, e.g. a sprite of a player
+struct Composite {
+	Payload members[16];
+};
+
+static void aliasingCases() {
+	const std::size_t n = 1000000;
+
+	bench("alias/my_shared_ptr_aliasing", n, [](std::size_t ops) {
+		auto owner = my_make_shared<Composite>();
+		std::vector<my_shared_ptr<Payload>> handed;
+		handed.reserve(ops);
+		for (std::size_t i = 0; i < ops; i++)
+			handed.push_back(my_shared_ptr<Payload>(owner, &owner->members[i % 16]));
+		doNotOptimize(handed.data());
+	});
+	bench("alias/std_shared_ptr_aliasing", n, [](std::size_t ops) {
+		auto owner = std::make_shared<Composite>();
+		std::vector<std::shared_ptr<Payload>> handed;
+		handed.reserve(ops);
+		for (std::size_t i = 0; i < ops; i++)
+			handed.push_back(std::shared_ptr<Payload>(owner, &owner->members[i % 16]));
+		doNotOptimize(handed.data());
+	});
+	// without aliasing, keeping the owner alive takes a separately allocated holder per member
+	bench("alias/my_shared_ptr_holder", n, [](std::size_t ops) {
+		struct Holder {
+			my_shared_ptr<Composite> owner;
+			Payload* member;
+		};
+		auto owner = my_make_shared<Composite>();
+		std::vector<my_shared_ptr<Holder>> handed;
+		handed.reserve(ops);
+		for (std::size_t i = 0; i < ops; i++)
+			handed.push_back(my_make_shared<Holder>(Holder{owner, &owner->members[i % 16]}));
+		doNotOptimize(handed.data());
+	});
+}
+
+
+// Pointer that counts how often it gets copied or moved; relocates like the pointer it wraps
+template<class Ptr>
+struct Counted : Ptr {
+	explicit Counted(Ptr ptr) : Ptr(std::move(ptr)) { }
+	Counted(const Counted& obj) : Ptr(obj) { gCopies++; }
+	Counted(Counted&& obj) noexcept(std::is_nothrow_move_constructible<Ptr>::value) : Ptr(std::move(obj)) { gMoves++; }
+	Counted& operator=(const Counted& obj) { gCopies++; Ptr::operator=(obj); return *this; }
+	Counted& operator=(Counted&& obj) noexcept(std::is_nothrow_move_assignable<Ptr>::value) { gMoves++; Ptr::operator=(std::move(obj)); return *this; }
+};
+
+template<class Ptr>
+struct my_is_trivially_relocatable<Counted<Ptr>> : my_is_trivially_relocatable<Ptr> { };
+
+// Growing a container of 1M pointers from empty, copies/moves show what the reallocations cost
+template<class Vector, class Make>
+static void growthLoop(std::size_t ops, Make make) {
+	typedef typename Vector::value_type Ptr;
+	Ptr ptr(make());
+	Vector v;
+	for (std::size_t i = 0; i < ops; i++)
+		v.push_back(ptr);
+	doNotOptimize(v.data());
+}
+
+static void growthCases() {
+	const std::size_t n = 1000000;
+
+	bench("growth/std_vector_my_shared_ptr", n, [](std::size_t ops) {
+		growthLoop<std::vector<Counted<my_shared_ptr<Payload>>>>(ops, [] { return Counted<my_shared_ptr<Payload>>(my_make_shared<Payload>(1)); });
+	});
+	bench("growth/std_vector_std_shared_ptr", n, [](std::size_t ops) {
+		growthLoop<std::vector<Counted<std::shared_ptr<Payload>>>>(ops, [] { return Counted<std::shared_ptr<Payload>>(std::make_shared<Payload>(1)); });
+	});
+	bench("growth/my_small_vector_my_shared_ptr", n, [](std::size_t ops) {
+		growthLoop<my_small_vector<Counted<my_shared_ptr<Payload>>>>(ops, [] { return Counted<my_shared_ptr<Payload>>(my_make_shared<Payload>(1)); });
+	});
+	bench("growth/my_small_vector_my_intrusive_ptr", n, [](std::size_t ops) {
+		growthLoop<my_small_vector<Counted<my_intrusive_ptr<RefPayload>>>>(ops, [] { return Counted<my_intrusive_ptr<RefPayload>>(my_intrusive_ptr<RefPayload>(new RefPayload(1))); });
+	});
+}
+
+
+static void printResults() {
+	if (gOptions.format == "csv") {
+		std::printf("name,ops,ns_per_op,allocs_per_op,bytes_per_op,copies_per_op,moves_per_op,peak_rss_kb\n");
+		for (const Result& r : gResults)
+			std::printf("%s,%zu,%.3f,%.3f,%.3f,%.3f,%.3f,%ld\n", r.name.c_str(), r.ops, r.nsPerOp, r.allocsPerOp, r.bytesPerOp, r.copiesPerOp, r.movesPerOp, r.peakRssKb);
+	}
+	else if (gOptions.format == "json") {
+		std::printf("[\n");
+		for (std::size_t i = 0; i < gResults.size(); i++) {
+			const Result& r = gResults[i];
+			std::printf("  {\"name\": \"%s\", \"ops\": %zu, \"ns_per_op\": %.3f, \"allocs_per_op\": %.3f, \"bytes_per_op\": %.3f, \"copies_per_op\": %.3f, \"moves_per_op\": %.3f, \"peak_rss_kb\": %ld}%s\n",
+				r.name.c_str(), r.ops, r.nsPerOp, r.allocsPerOp, r.bytesPerOp, r.copiesPerOp, r.movesPerOp, r.peakRssKb, i + 1 < gResults.size() ? "," : "");
+		}
+		std::printf("]\n");
+	}
+	else {
+		std::printf("%-44s %12s %10s %10s %10s %10s %12s\n", "name", "ns/op", "allocs/op", "bytes/op", "copies/op", "moves/op", "peak rss kB");
+		for (const Result& r : gResults) {
+			std::printf("%-44s %12.2f %10.2f %10.1f %10.2f %10.2f ", r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.bytesPerOp, r.copiesPerOp, r.movesPerOp);
+			if (r.peakRssKb >= 0)
+				std::printf("%12ld\n", r.peakRssKb);
+			else
+				std::printf("%12s\n", "-");
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg.rfind("--format=", 0) == 0)
+			gOptions.format = arg.substr(9);
+		else if (arg.rfind("--filter=", 0) == 0)
+			gOptions.filter = arg.substr(9);
+		else if (arg.rfind("--scale=", 0) == 0)
+			gOptions.scale = std::atof(arg.c_str() + 8);
+		else {
+			std::fprintf(stderr, "usage: %s [--format=table|csv|json] [--filter=substring] [--scale=factor]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	constructionCases();
+	copyCases();
+	moveCases();
+	dereferenceCases();
+	shuffledCopyCases();
+	sortCases();
+	growthCases();
+	aliasingCases();
+	threadedCases();
+	churnCases();
+	bufferCases();
+
+	printResults();
+	return 0;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <memory>
+#include <new>
+#include <utility>
+#include "my_ref_count.hpp"
+
+#ifndef MY_CACHE_LINE_SIZE
+#define MY_CACHE_LINE_SIZE 64
+#endif
+
+// Everything my_shared_ptr and my_weak_ptr need to know about an owned object:
+// how many owners it has and how to get rid of it.
+// The object dies with the last strong owner, the block itself with the last weak one.
+// All strong owners together hold a single weak reference, so the block can't go
+// away while the object is still being disposed.
+template<my_lock_policy Policy>
+class my_control_block {
+private:
+	my_ref_count<Policy> strongCount;
+	my_ref_count<Policy> weakCount;
+
+public:
+	my_control_block() : strongCount(1), weakCount(1) { }
+
+	my_control_block(const my_control_block&) = delete;
+	my_control_block& operator=(const my_control_block&) = delete;
+
+	void add_ref() {
+		strongCount.add_ref();
+	}
+
+	bool add_ref_if_alive() {
+		return strongCount.add_ref_if_alive();
+	}
+
+	void release() {
+		if (strongCount.release()) {
+			dispose();
+			release_weak();
+		}
+	}
+
+	void add_weak_ref() {
+		weakCount.add_ref();
+	}
+
+	void release_weak() {
+		if (weakCount.release())
+			destroy();
+	}
+
+	uint use_count() const {
+		return strongCount.get();
+	}
+
+protected:
+	virtual ~my_control_block() { }
+
+	// destroys the owned object
+	virtual void dispose() = 0;
+
+	// frees the block itself
+	virtual void destroy() {
+		delete this;
+	}
+};
+
+// Block for my_shared_ptr<T>(new T): object and counter live in two allocations
+template<class T, my_lock_policy Policy>
+class my_control_block_ptr : public my_control_block<Policy> {
+private:
+	T* ptr;
+
+public:
+	explicit my_control_block_ptr(T* ptr) : ptr(ptr) { }
+
+protected:
+	void dispose() override {
+		delete ptr;
+	}
+};
+
+// Block for my_make_shared: object is stored right after the counter
+template<class T, my_lock_policy Policy>
+class my_control_block_inplace : public my_control_block<Policy> {
+private:
+	alignas(T) unsigned char storage[sizeof(T)];
+
+public:
+	template<class... Args>
+	explicit my_control_block_inplace(Args&&... args) {
+		::new (static_cast<void*>(storage)) T(std::forward<Args>(args)...);
+	}
+
+	T* get() {
+		return std::launder(reinterpret_cast<T*>(storage));
+	}
+
+protected:
+	void dispose() override {
+		get()->~T();
+	}
+};
+
+// Block for my_make_shared_padded: starts on its own cache line and fills it, so counts
+// hammered from several threads never share a line with a neighbouring block.
+// Costs up to a cache line per object, so only worth it for such shared hot objects.
+template<class T, my_lock_policy Policy>
+class alignas(MY_CACHE_LINE_SIZE) my_control_block_padded : public my_control_block_inplace<T, Policy> {
+public:
+	using my_control_block_inplace<T, Policy>::my_control_block_inplace;
+};
+
+// Same layout as my_control_block_inplace, but the memory comes from Alloc
+// and goes back to it once the last weak owner is gone
+template<class T, my_lock_policy Policy, class Alloc>
+class my_control_block_alloc : public my_control_block<Policy> {
+public:
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<my_control_block_alloc> block_allocator;
+	typedef std::allocator_traits<block_allocator> block_traits;
+
+private:
+	block_allocator alloc;
+	alignas(T) unsigned char storage[sizeof(T)];
+
+public:
+	template<class... Args>
+	explicit my_control_block_alloc(const Alloc& alloc, Args&&... args) : alloc(alloc) {
+		::new (static_cast<void*>(storage)) T(std::forward<Args>(args)...);
+	}
+
+	T* get() {
+		return std::launder(reinterpret_cast<T*>(storage));
+	}
+
+protected:
+	void dispose() override {
+		get()->~T();
+	}
+
+	void destroy() override {
+		block_allocator blockAlloc(alloc);
+		this->~my_control_block_alloc();
+		block_traits::deallocate(blockAlloc, this, 1);
+	}
+};
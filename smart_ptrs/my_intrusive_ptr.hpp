@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include "my_ref_count.hpp"
+#include "my_relocatable.hpp"
+
+// CRTP base keeping the counter inside the object itself:
+//     class Node : public my_ref_counted<Node> { ... };
+// If Node has subclasses, Node needs a virtual destructor.
+template<class T, my_lock_policy Policy = my_lock_policy::atomic>
+class my_ref_counted {
+private:
+	mutable my_ref_count<Policy> refCount;
+
+protected:
+	my_ref_counted() : refCount(0) { }
+
+	// a copy is a new object nobody owns yet
+	my_ref_counted(const my_ref_counted&) : refCount(0) { }
+
+	my_ref_counted& operator=(const my_ref_counted&) {
+		return *this;
+	}
+
+	~my_ref_counted() { }
+
+public:
+	void add_ref() const {
+		refCount.add_ref();
+	}
+
+	void release() const {
+		if (refCount.release())
+			delete static_cast<const T*>(this);
+	}
+
+	uint use_count() const {
+		return refCount.get();
+	}
+};
+
+// Works with any T providing add_ref() and release(), normally through my_ref_counted
+template<class T>
+class my_intrusive_ptr {
+private:
+	T* ptr = nullptr;
+
+public:
+	my_intrusive_ptr() : ptr(nullptr) { }
+
+	my_intrusive_ptr(std::nullptr_t) : ptr(nullptr) { }
+
+	// addRef = false adopts a reference the caller already holds
+	my_intrusive_ptr(T* ptr, bool addRef = true) : ptr(ptr) {
+		if (ptr != nullptr && addRef)
+			ptr->add_ref();
+	}
+
+	my_intrusive_ptr(const my_intrusive_ptr& obj) : ptr(obj.ptr) {
+		if (ptr != nullptr)
+			ptr->add_ref();
+	}
+
+	// Copy first, then let the copy release the old object: obj may be owned by that object
+	my_intrusive_ptr& operator=(const my_intrusive_ptr& obj) {
+		my_intrusive_ptr(obj).swap(*this);
+		return *this;
+	}
+
+	my_intrusive_ptr(my_intrusive_ptr&& dyingObj) noexcept : ptr(dyingObj.ptr) {
+		dyingObj.ptr = nullptr;
+	}
+
+	my_intrusive_ptr& operator=(my_intrusive_ptr&& dyingObj) noexcept {
+		my_intrusive_ptr(std::move(dyingObj)).swap(*this);
+		return *this;
+	}
+
+	void swap(my_intrusive_ptr& obj) noexcept {
+		std::swap(ptr, obj.ptr);
+	}
+
+	uint get_count() const {
+		return ptr != nullptr ? ptr->use_count() : 0;
+	}
+
+	T* get() const {
+		return ptr;
+	}
+
+	T* operator->() const {
+		return ptr;
+	}
+
+	T& operator*() const {
+		return *ptr;
+	}
+
+	explicit operator bool() const {
+		return ptr;
+	}
+
+	void reset() {
+		my_intrusive_ptr().swap(*this);
+	}
+
+	~my_intrusive_ptr() {
+		__cleanup__();
+	}
+
+private:
+	void __cleanup__() {
+		if (ptr != nullptr)
+			ptr->release();
+	}
+};
+
+template<class T>
+void swap(my_intrusive_ptr<T>& a, my_intrusive_ptr<T>& b) noexcept {
+	a.swap(b);
+}
+
+template<class T>
+struct my_is_trivially_relocatable<my_intrusive_ptr<T>> : std::true_type { };
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+// Fixed-size block pool, one instance per (Size, Align) pair.
+// Every thread allocates from and frees to its own freelist without any locking.
+// Surplus lists (and the whole list of an exiting thread) are handed over to a shared
+// lock-free stack that other threads grab from in one piece, which avoids ABA entirely.
+// Memory is taken from the heap in chunks and is never given back.
+template<std::size_t Size, std::size_t Align>
+class my_fixed_pool {
+private:
+	struct node {
+		node* next;
+	};
+
+	static constexpr std::size_t kAlign = Align < alignof(node) ? alignof(node) : Align;
+	static constexpr std::size_t kBlockSize = ((Size < sizeof(node) ? sizeof(node) : Size) + kAlign - 1) / kAlign * kAlign;
+	static constexpr std::size_t kBlocksPerChunk = 256;
+	static constexpr std::size_t kMaxLocalBlocks = 4 * kBlocksPerChunk;
+
+	struct freelist {
+		node* head = nullptr;
+		node* tail = nullptr;
+		std::size_t count = 0;
+
+		~freelist() {
+			give_away(*this);
+		}
+	};
+
+	inline static std::atomic<node*> sharedHead {nullptr};
+
+	static freelist& local() {
+		thread_local freelist list;
+		return list;
+	}
+
+	static void give_away(freelist& list) {
+		if (list.head == nullptr)
+			return;
+
+		list.tail->next = sharedHead.load(std::memory_order_relaxed);
+		while (!sharedHead.compare_exchange_weak(list.tail->next, list.head, std::memory_order_release, std::memory_order_relaxed)) { }
+
+		list.head = list.tail = nullptr;
+		list.count = 0;
+	}
+
+	static void refill(freelist& list) {
+		node* taken = sharedHead.exchange(nullptr, std::memory_order_acquire);
+		if (taken == nullptr) {
+			unsigned char* chunk = static_cast<unsigned char*>(::operator new(kBlockSize * kBlocksPerChunk, std::align_val_t(kAlign)));
+			for (std::size_t i = 0; i < kBlocksPerChunk; i++)
+				push(list, ::new (static_cast<void*>(chunk + i * kBlockSize)) node{nullptr});
+			return;
+		}
+		while (taken != nullptr) {
+			node* next = taken->next;
+			push(list, taken);
+			taken = next;
+		}
+	}
+
+	static void push(freelist& list, node* n) {
+		n->next = list.head;
+		if (list.head == nullptr)
+			list.tail = n;
+		list.head = n;
+		list.count++;
+	}
+
+public:
+	static void* allocate() {
+		freelist& list = local();
+		if (list.head == nullptr)
+			refill(list);
+
+		node* n = list.head;
+		list.head = n->next;
+		list.count--;
+		return n;
+	}
+
+	static void deallocate(void* p) {
+		freelist& list = local();
+		push(list, static_cast<node*>(p));
+		// a thread that only frees (consumer side) would otherwise hoard everything
+		if (list.count > kMaxLocalBlocks)
+			give_away(list);
+	}
+};
+
+// Standard allocator on top of my_fixed_pool. Single objects come from the pool,
+// arrays fall through to the global heap.
+template<class T>
+class my_pool_allocator {
+public:
+	typedef T value_type;
+
+	my_pool_allocator() { }
+
+	template<class U>
+	my_pool_allocator(const my_pool_allocator<U>&) { }
+
+	T* allocate(std::size_t n) {
+		if (n == 1)
+			return static_cast<T*>(my_fixed_pool<sizeof(T), alignof(T)>::allocate());
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+	}
+
+	void deallocate(T* p, std::size_t n) {
+		if (n == 1)
+			my_fixed_pool<sizeof(T), alignof(T)>::deallocate(p);
+		else
+			::operator delete(p, std::align_val_t(alignof(T)));
+	}
+};
+
+template<class T, class U>
+bool operator==(const my_pool_allocator<T>&, const my_pool_allocator<U>&) {
+	return true;
+}
+
+template<class T, class U>
+bool operator!=(const my_pool_allocator<T>&, const my_pool_allocator<U>&) {
+	return false;
+}
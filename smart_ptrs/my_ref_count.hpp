@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+
+typedef unsigned int uint;
+
+// single - plain counter for pointers that never leave one thread
+// atomic - safe to copy and destroy owners concurrently from several threads
+enum class my_lock_policy { single, atomic };
+
+template<my_lock_policy Policy>
+class my_ref_count;
+
+template<>
+class my_ref_count<my_lock_policy::single> {
+private:
+	uint count;
+
+public:
+	explicit my_ref_count(uint count = 1) : count(count) { }
+
+	void add_ref() {
+		count++;
+	}
+
+	// true when the last reference has gone
+	bool release() {
+		return --count == 0;
+	}
+
+	// adds a reference only if there still is one, used to revive a weak owner
+	bool add_ref_if_alive() {
+		if (count == 0)
+			return false;
+		count++;
+		return true;
+	}
+
+	uint get() const {
+		return count;
+	}
+};
+
+template<>
+class my_ref_count<my_lock_policy::atomic> {
+private:
+	std::atomic<uint> count;
+
+public:
+	explicit my_ref_count(uint count = 1) : count(count) { }
+
+	void add_ref() {
+		// a new owner is always made from an existing one, so nothing to order here
+		count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	bool release() {
+		// release publishes our writes to the object, acquire makes
+		// every other owner's writes visible before it gets destroyed
+		return count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+	}
+
+	bool add_ref_if_alive() {
+		// a plain increment could bring back an object that is already being destroyed
+		uint current = count.load(std::memory_order_relaxed);
+		while (current != 0) {
+			if (count.compare_exchange_weak(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed))
+				return true;
+		}
+		return false;
+	}
+
+	uint get() const {
+		return count.load(std::memory_order_relaxed);
+	}
+};
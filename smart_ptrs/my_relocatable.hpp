@@ -0,0 +1,13 @@
+#pragma once
+
+#include <type_traits>
+
+// A type is trivially relocatable when moving it to a new address and forgetting
+// the old copy is the same as a memcpy: no constructor or destructor needs to run.
+// Containers use this to grow with a single memcpy instead of moving element by element.
+// Specialize it for types that own their resources through plain pointers.
+template<class T>
+struct my_is_trivially_relocatable : std::is_trivially_copyable<T> { };
+
+template<class T>
+constexpr bool my_is_trivially_relocatable_v = my_is_trivially_relocatable<T>::value;
@@ -1,50 +1,117 @@
-typedef unsigned int uint;
+#pragma once
 
-template<class T>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "my_control_block.hpp"
+#include "my_relocatable.hpp"
+
+template<class T, my_lock_policy Policy = my_lock_policy::atomic>
 class my_shared_ptr {
 private:
+	typedef my_control_block<Policy> count_type;
+
 	T* ptr = nullptr;
-	uint* refCount = nullptr;
+	count_type* refCount = nullptr;
+
+	template<class U, my_lock_policy P, class... Args>
+	friend my_shared_ptr<U, P> my_make_shared(Args&&... args);
+
+	template<class U, my_lock_policy P, class... Args>
+	friend my_shared_ptr<U, P> my_make_shared_padded(Args&&... args);
+
+	template<class U, my_lock_policy P, class Alloc, class... Args>
+	friend my_shared_ptr<U, P> my_allocate_shared(const Alloc& alloc, Args&&... args);
+
+	template<class U, my_lock_policy P>
+	friend class my_weak_ptr;
+
+	template<class U, my_lock_policy P>
+	friend class my_shared_ptr;
+
+	// takes over a block that already counts this owner
+	my_shared_ptr(T* ptr, count_type* refCount) : ptr(ptr), refCount(refCount) { }
 
 public:
-	my_shared_ptr() : ptr(nullptr), refCount(new uint(0)) { }
+	my_shared_ptr() : ptr(nullptr), refCount(nullptr) { }
 
-	my_shared_ptr(T* ptr) : ptr(ptr), refCount(new uint(1)) { }
+	my_shared_ptr(std::nullptr_t) : ptr(nullptr), refCount(nullptr) { }
+
+	// Like std::shared_ptr, deletes ptr if the control block can't be allocated
+	my_shared_ptr(T* ptr) : ptr(ptr), refCount(nullptr) {
+		if (ptr == nullptr)
+			return;
+		try {
+			refCount = new my_control_block_ptr<T, Policy>(ptr);
+		}
+		catch (...) {
+			delete ptr;
+			throw;
+		}
+	}
 
 	my_shared_ptr(const my_shared_ptr& obj) {
 		ptr = obj.ptr;
 		refCount = obj.refCount;
-		if (obj.ptr != nullptr)
-			(*refCount)++;
+		if (refCount != nullptr)
+			refCount->add_ref();
 	}
 
+	// Copy first, then let the copy release the old object: obj may be owned by that object
 	my_shared_ptr& operator=(const my_shared_ptr& obj) {
-		__cleanup__(); 
+		my_shared_ptr(obj).swap(*this);
+		return *this;
+	}
 
-		ptr = obj.ptr;
-		refCount = obj.refCount;
-		if (obj.ptr != nullptr)
-			(*refCount)++;
+	// Aliasing: shares owner's lifetime and control block but points to ptr,
+	// normally a member of the owned object. Nothing is allocated.
+	template<class U>
+	my_shared_ptr(const my_shared_ptr<U, Policy>& owner, T* ptr) : ptr(ptr), refCount(owner.refCount) {
+		if (refCount != nullptr)
+			refCount->add_ref();
+	}
+
+	template<class U>
+	my_shared_ptr(my_shared_ptr<U, Policy>&& owner, T* ptr) noexcept : ptr(ptr), refCount(owner.refCount) {
+		owner.ptr = nullptr;
+		owner.refCount = nullptr;
 	}
 
-	my_shared_ptr(my_shared_ptr&& dyingObj) {
+	// my_shared_ptr<Derived> -> my_shared_ptr<Base>
+	template<class U, class = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+	my_shared_ptr(const my_shared_ptr<U, Policy>& obj) : my_shared_ptr(obj, obj.ptr) { }
+
+	template<class U, class = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+	my_shared_ptr(my_shared_ptr<U, Policy>&& obj) noexcept : my_shared_ptr(std::move(obj), obj.ptr) { }
+
+	my_shared_ptr(my_shared_ptr&& dyingObj) noexcept {
 		ptr = dyingObj.ptr;
 		refCount = dyingObj.refCount;
 
-		dyingObj.ptr = dyingObj.refCount = nullptr;
+		dyingObj.ptr = nullptr;
+		dyingObj.refCount = nullptr;
 	}
 
-	my_shared_ptr& operator=(my_shared_ptr && dyingObj) {
-		__cleanup__();
-		
-		ptr = dyingObj.ptr;
-		refCount = dyingObj.refCount;
+	my_shared_ptr& operator=(my_shared_ptr && dyingObj) noexcept {
+		my_shared_ptr(std::move(dyingObj)).swap(*this);
+		return *this;
+	}
+
+	void swap(my_shared_ptr& obj) noexcept {
+		std::swap(ptr, obj.ptr);
+		std::swap(refCount, obj.refCount);
+	}
 
-		dyingObj.ptr = dyingObj.refCount = nullptr;
+	void reset() {
+		my_shared_ptr().swap(*this);
+	}
+
+	void reset(T* newPtr) {
+		my_shared_ptr(newPtr).swap(*this);
 	}
 
 	uint get_count() const {
-		return *refCount;
+		return refCount != nullptr ? refCount->use_count() : 0;
 	}
 
 	T* get() const {
@@ -56,6 +123,10 @@ public:
 	}
 
 	T& operator*() const {
+		return *ptr;
+	}
+
+	explicit operator bool() const {
 		return ptr;
 	}
 
@@ -65,11 +136,70 @@ public:
 
 private:
 	void __cleanup__() {
-		(*refCount)--;
-		if (*refCount == 0) {
-			if (nullptr != ptr)
-				delete ptr;
-			delete refCount;
-		}
+		if (refCount != nullptr)
+			refCount->release();
 	}
-};
\ No newline at end of file
+};
+
+template<class T, my_lock_policy Policy>
+void swap(my_shared_ptr<T, Policy>& a, my_shared_ptr<T, Policy>& b) noexcept {
+	a.swap(b);
+}
+
+template<class T, my_lock_policy Policy>
+struct my_is_trivially_relocatable<my_shared_ptr<T, Policy>> : std::true_type { };
+
+// Casts keep sharing the control block of the source pointer
+template<class T, class U, my_lock_policy Policy>
+my_shared_ptr<T, Policy> my_static_pointer_cast(const my_shared_ptr<U, Policy>& obj) {
+	return my_shared_ptr<T, Policy>(obj, static_cast<T*>(obj.get()));
+}
+
+// empty pointer if the object is not a T
+template<class T, class U, my_lock_policy Policy>
+my_shared_ptr<T, Policy> my_dynamic_pointer_cast(const my_shared_ptr<U, Policy>& obj) {
+	T* ptr = dynamic_cast<T*>(obj.get());
+	if (ptr == nullptr)
+		return my_shared_ptr<T, Policy>();
+	return my_shared_ptr<T, Policy>(obj, ptr);
+}
+
+template<class T, class U, my_lock_policy Policy>
+my_shared_ptr<T, Policy> my_const_pointer_cast(const my_shared_ptr<U, Policy>& obj) {
+	return my_shared_ptr<T, Policy>(obj, const_cast<T*>(obj.get()));
+}
+
+// One allocation for both the object and its counter
+template<class T, my_lock_policy Policy = my_lock_policy::atomic, class... Args>
+my_shared_ptr<T, Policy> my_make_shared(Args&&... args) {
+	auto* block = new my_control_block_inplace<T, Policy>(std::forward<Args>(args)...);
+	return my_shared_ptr<T, Policy>(block->get(), block);
+}
+
+// my_make_shared with the block on a cache line of its own, see my_control_block_padded
+template<class T, my_lock_policy Policy = my_lock_policy::atomic, class... Args>
+my_shared_ptr<T, Policy> my_make_shared_padded(Args&&... args) {
+	auto* block = new my_control_block_padded<T, Policy>(std::forward<Args>(args)...);
+	return my_shared_ptr<T, Policy>(block->get(), block);
+}
+
+// Like my_make_shared, but the block is allocated with alloc (e.g. my_pool_allocator)
+template<class T, my_lock_policy Policy = my_lock_policy::atomic, class Alloc, class... Args>
+my_shared_ptr<T, Policy> my_allocate_shared(const Alloc& alloc, Args&&... args) {
+	typedef my_control_block_alloc<T, Policy, Alloc> block_type;
+	typename block_type::block_allocator blockAlloc(alloc);
+
+	block_type* block = block_type::block_traits::allocate(blockAlloc, 1);
+	try {
+		::new (static_cast<void*>(block)) block_type(alloc, std::forward<Args>(args)...);
+	}
+	catch (...) {
+		block_type::block_traits::deallocate(blockAlloc, block, 1);
+		throw;
+	}
+	return my_shared_ptr<T, Policy>(block->get(), block);
+}
+
+// same pointer without atomics, for objects that never leave one thread
+template<class T>
+using my_local_shared_ptr = my_shared_ptr<T, my_lock_policy::single>;
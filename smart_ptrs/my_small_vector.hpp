@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "my_relocatable.hpp"
+
+// Vector keeping the first N elements inside the object itself.
+// When it has to grow, trivially relocatable elements (e.g. all my_* pointers)
+// are carried over with one memcpy: no copies, no moves, no refcount traffic.
+template<class T, std::size_t N = 8>
+class my_small_vector {
+private:
+	T* first;
+	std::size_t count = 0;
+	std::size_t cap = N;
+	alignas(T) unsigned char inlineStorage[N * sizeof(T) > 0 ? N * sizeof(T) : 1];
+
+	T* inline_data() {
+		return reinterpret_cast<T*>(inlineStorage);
+	}
+
+	bool is_inline() const {
+		return first == reinterpret_cast<const T*>(inlineStorage);
+	}
+
+	static T* allocate(std::size_t n) {
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+	}
+
+	static void deallocate(T* p) {
+		::operator delete(p, std::align_val_t(alignof(T)));
+	}
+
+	// moves count elements from src to raw memory at dst and ends the lifetime of the sources
+	static void relocate(T* src, std::size_t count, T* dst) {
+		if constexpr (my_is_trivially_relocatable_v<T>) {
+			if (count != 0)
+				std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(T));
+		}
+		else {
+			for (std::size_t i = 0; i < count; i++) {
+				::new (static_cast<void*>(dst + i)) T(std::move_if_noexcept(src[i]));
+				src[i].~T();
+			}
+		}
+	}
+
+	void grow(std::size_t minCapacity) {
+		std::size_t newCap = cap * 2 > minCapacity ? cap * 2 : minCapacity;
+		T* newData = allocate(newCap);
+		relocate(first, count, newData);
+		if (!is_inline())
+			deallocate(first);
+		first = newData;
+		cap = newCap;
+	}
+
+	void release_storage() {
+		clear();
+		if (!is_inline())
+			deallocate(first);
+		first = inline_data();
+		cap = N;
+	}
+
+public:
+	typedef T value_type;
+	typedef T* iterator;
+	typedef const T* const_iterator;
+
+	my_small_vector() : first(inline_data()) { }
+
+	my_small_vector(const my_small_vector& obj) : first(inline_data()) {
+		reserve(obj.count);
+		for (const T& el : obj)
+			push_back(el);
+	}
+
+	my_small_vector& operator=(const my_small_vector& obj) {
+		if (this == &obj)
+			return *this;
+
+		clear();
+		reserve(obj.count);
+		for (const T& el : obj)
+			push_back(el);
+		return *this;
+	}
+
+	my_small_vector(my_small_vector&& dyingObj) noexcept(my_is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible<T>::value) : first(inline_data()) {
+		take(dyingObj);
+	}
+
+	my_small_vector& operator=(my_small_vector&& dyingObj) noexcept(my_is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible<T>::value) {
+		if (this == &dyingObj)
+			return *this;
+
+		release_storage();
+		take(dyingObj);
+		return *this;
+	}
+
+	~my_small_vector() {
+		release_storage();
+	}
+
+	std::size_t size() const {
+		return count;
+	}
+
+	std::size_t capacity() const {
+		return cap;
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+
+	T* data() {
+		return first;
+	}
+
+	const T* data() const {
+		return first;
+	}
+
+	T& operator[](std::size_t i) {
+		return first[i];
+	}
+
+	const T& operator[](std::size_t i) const {
+		return first[i];
+	}
+
+	T& back() {
+		return first[count - 1];
+	}
+
+	iterator begin() {
+		return first;
+	}
+
+	iterator end() {
+		return first + count;
+	}
+
+	const_iterator begin() const {
+		return first;
+	}
+
+	const_iterator end() const {
+		return first + count;
+	}
+
+	void reserve(std::size_t newCap) {
+		if (newCap > cap)
+			grow(newCap);
+	}
+
+	template<class... Args>
+	T& emplace_back(Args&&... args) {
+		if (count == cap) {
+			// the argument may live inside this vector, build the element before moving the rest away
+			T tmp(std::forward<Args>(args)...);
+			grow(count + 1);
+			::new (static_cast<void*>(first + count)) T(std::move(tmp));
+		}
+		else {
+			::new (static_cast<void*>(first + count)) T(std::forward<Args>(args)...);
+		}
+		return first[count++];
+	}
+
+	void push_back(const T& value) {
+		emplace_back(value);
+	}
+
+	void push_back(T&& value) {
+		emplace_back(std::move(value));
+	}
+
+	void pop_back() {
+		first[--count].~T();
+	}
+
+	void clear() {
+		for (std::size_t i = 0; i < count; i++)
+			first[i].~T();
+		count = 0;
+	}
+
+private:
+	// steals the heap buffer or relocates inline elements, dyingObj is left empty
+	void take(my_small_vector& dyingObj) {
+		if (dyingObj.is_inline()) {
+			relocate(dyingObj.first, dyingObj.count, first);
+		}
+		else {
+			first = dyingObj.first;
+			cap = dyingObj.cap;
+			dyingObj.first = dyingObj.inline_data();
+			dyingObj.cap = N;
+		}
+		count = dyingObj.count;
+		dyingObj.count = 0;
+	}
+};
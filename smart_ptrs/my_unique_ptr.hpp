@@ -1,6 +1,65 @@
-template <class T>
-class my_unique_ptr {
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "my_relocatable.hpp"
+
+template<class T>
+struct my_default_delete {
+	void operator()(T* ptr) const {
+		delete ptr;
+	}
+};
+
+template<class T>
+struct my_default_delete<T[]> {
+	void operator()(T* ptr) const {
+		delete[] ptr;
+	}
+};
+
+// Stateless deleters are stored as an empty base, so they take no space
+template<class Deleter, bool = std::is_empty<Deleter>::value && !std::is_final<Deleter>::value>
+class my_deleter_holder : private Deleter {
+public:
+	my_deleter_holder() { }
+	my_deleter_holder(const Deleter& deleter) : Deleter(deleter) { }
+	my_deleter_holder(Deleter&& deleter) : Deleter(std::move(deleter)) { }
+
+	Deleter& get_deleter() {
+		return *this;
+	}
+
+	const Deleter& get_deleter() const {
+		return *this;
+	}
+};
+
+template<class Deleter>
+class my_deleter_holder<Deleter, false> {
 private:
+	Deleter deleter;
+
+public:
+	my_deleter_holder() : deleter() { }
+	my_deleter_holder(const Deleter& deleter) : deleter(deleter) { }
+	my_deleter_holder(Deleter&& deleter) : deleter(std::move(deleter)) { }
+
+	Deleter& get_deleter() {
+		return deleter;
+	}
+
+	const Deleter& get_deleter() const {
+		return deleter;
+	}
+};
+
+template <class T, class Deleter = my_default_delete<T>>
+class my_unique_ptr : private my_deleter_holder<Deleter> {
+private:
+	typedef my_deleter_holder<Deleter> deleter_base;
+
 	T* ptr = nullptr;
 
 public:
@@ -8,26 +67,58 @@ public:
 
 	explicit my_unique_ptr(T* ptr) : ptr(ptr) { }
 
+	my_unique_ptr(T* ptr, const Deleter& deleter) : deleter_base(deleter), ptr(ptr) { }
+
 	my_unique_ptr(const my_unique_ptr& obj) = delete;
 	my_unique_ptr& operator=(const my_unique_ptr& obj) = delete;
 
-	my_unique_ptr(my_unique_ptr&& dyingObj) {
+	my_unique_ptr(my_unique_ptr&& dyingObj) noexcept : deleter_base(std::move(dyingObj.get_deleter())) {
 		this->ptr = dyingObj.ptr;
-		dyingObj.ptr = nullptr; 
+		dyingObj.ptr = nullptr;
 	}
 
-	void operator=(my_unique_ptr&& dyingObj) {
+	my_unique_ptr& operator=(my_unique_ptr&& dyingObj) noexcept {
+		if (this == &dyingObj)
+			return *this;
+
 		__cleanup__();
 
 		this->ptr = dyingObj.ptr;
 		dyingObj.ptr = nullptr;
+		get_deleter() = std::move(dyingObj.get_deleter());
+		return *this;
+	}
+
+	using deleter_base::get_deleter;
+
+	// gives up ownership without deleting
+	T* release() noexcept {
+		T* old = ptr;
+		ptr = nullptr;
+		return old;
 	}
 
-	T* operator->() {
+	void reset(T* newPtr = nullptr) {
+		T* old = ptr;
+		ptr = newPtr;
+		if (old != nullptr)
+			get_deleter()(old);
+	}
+
+	void swap(my_unique_ptr& obj) noexcept {
+		std::swap(ptr, obj.ptr);
+		std::swap(get_deleter(), obj.get_deleter());
+	}
+
+	T* get() const {
 		return ptr;
 	}
 
-	T& operator*() {
+	T* operator->() const {
+		return ptr;
+	}
+
+	T& operator*() const {
 		return *ptr;
 	}
 
@@ -42,6 +133,109 @@ public:
 private:
 	void __cleanup__() {
 		if (ptr != nullptr)
-			delete ptr;
+			get_deleter()(ptr);
+	}
+};
+
+// Owner of a new[]-allocated buffer
+template <class T, class Deleter>
+class my_unique_ptr<T[], Deleter> : private my_deleter_holder<Deleter> {
+private:
+	typedef my_deleter_holder<Deleter> deleter_base;
+
+	T* ptr = nullptr;
+
+public:
+	my_unique_ptr() : ptr(nullptr) { }
+
+	explicit my_unique_ptr(T* ptr) : ptr(ptr) { }
+
+	my_unique_ptr(T* ptr, const Deleter& deleter) : deleter_base(deleter), ptr(ptr) { }
+
+	my_unique_ptr(const my_unique_ptr& obj) = delete;
+	my_unique_ptr& operator=(const my_unique_ptr& obj) = delete;
+
+	my_unique_ptr(my_unique_ptr&& dyingObj) noexcept : deleter_base(std::move(dyingObj.get_deleter())) {
+		this->ptr = dyingObj.ptr;
+		dyingObj.ptr = nullptr;
+	}
+
+	my_unique_ptr& operator=(my_unique_ptr&& dyingObj) noexcept {
+		if (this == &dyingObj)
+			return *this;
+
+		__cleanup__();
+
+		this->ptr = dyingObj.ptr;
+		dyingObj.ptr = nullptr;
+		get_deleter() = std::move(dyingObj.get_deleter());
+		return *this;
+	}
+
+	using deleter_base::get_deleter;
+
+	// gives up ownership without deleting
+	T* release() noexcept {
+		T* old = ptr;
+		ptr = nullptr;
+		return old;
+	}
+
+	void reset(T* newPtr = nullptr) {
+		T* old = ptr;
+		ptr = newPtr;
+		if (old != nullptr)
+			get_deleter()(old);
+	}
+
+	void swap(my_unique_ptr& obj) noexcept {
+		std::swap(ptr, obj.ptr);
+		std::swap(get_deleter(), obj.get_deleter());
+	}
+
+	T* get() const {
+		return ptr;
+	}
+
+	T& operator[](std::size_t i) const {
+		return ptr[i];
+	}
+
+	explicit operator bool() const {
+		return ptr;
+	}
+
+	~my_unique_ptr() {
+		__cleanup__();
+	}
+
+private:
+	void __cleanup__() {
+		if (ptr != nullptr)
+			get_deleter()(ptr);
 	}
-};
\ No newline at end of file
+};
+
+template<class T, class Deleter>
+void swap(my_unique_ptr<T, Deleter>& a, my_unique_ptr<T, Deleter>& b) noexcept {
+	a.swap(b);
+}
+
+// the deleter is moved along with the pointer, so it has to be relocatable too
+template<class T, class Deleter>
+struct my_is_trivially_relocatable<my_unique_ptr<T, Deleter>> : my_is_trivially_relocatable<Deleter> { };
+
+// Buffer of n default-initialized elements: for trivial T the memory is left
+// as is instead of being zeroed, so large scratch buffers cost no memset
+template<class T>
+std::enable_if_t<std::is_array<T>::value && std::extent<T>::value == 0, my_unique_ptr<T>>
+my_make_unique_for_overwrite(std::size_t n) {
+	return my_unique_ptr<T>(new std::remove_extent_t<T>[n]);
+}
+
+// Same with value-initialized (zeroed for trivial T) elements
+template<class T>
+std::enable_if_t<std::is_array<T>::value && std::extent<T>::value == 0, my_unique_ptr<T>>
+my_make_unique(std::size_t n) {
+	return my_unique_ptr<T>(new std::remove_extent_t<T>[n]());
+}
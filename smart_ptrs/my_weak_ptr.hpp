@@ -0,0 +1,108 @@
+#pragma once
+
+#include "my_shared_ptr.hpp"
+
+// Non-owning observer of a my_shared_ptr, used to break ownership cycles
+// such as child -> parent back-links
+template<class T, my_lock_policy Policy = my_lock_policy::atomic>
+class my_weak_ptr {
+private:
+	typedef my_control_block<Policy> count_type;
+
+	T* ptr = nullptr;
+	count_type* refCount = nullptr;
+
+public:
+	my_weak_ptr() : ptr(nullptr), refCount(nullptr) { }
+
+	my_weak_ptr(const my_shared_ptr<T, Policy>& obj) : ptr(obj.ptr), refCount(obj.refCount) {
+		if (refCount != nullptr)
+			refCount->add_weak_ref();
+	}
+
+	my_weak_ptr(const my_weak_ptr& obj) : ptr(obj.ptr), refCount(obj.refCount) {
+		if (refCount != nullptr)
+			refCount->add_weak_ref();
+	}
+
+	my_weak_ptr& operator=(const my_weak_ptr& obj) {
+		if (this == &obj)
+			return *this;
+
+		__cleanup__();
+
+		ptr = obj.ptr;
+		refCount = obj.refCount;
+		if (refCount != nullptr)
+			refCount->add_weak_ref();
+		return *this;
+	}
+
+	my_weak_ptr& operator=(const my_shared_ptr<T, Policy>& obj) {
+		return *this = my_weak_ptr(obj);
+	}
+
+	my_weak_ptr(my_weak_ptr&& dyingObj) noexcept {
+		ptr = dyingObj.ptr;
+		refCount = dyingObj.refCount;
+
+		dyingObj.ptr = nullptr;
+		dyingObj.refCount = nullptr;
+	}
+
+	my_weak_ptr& operator=(my_weak_ptr&& dyingObj) noexcept {
+		if (this == &dyingObj)
+			return *this;
+
+		__cleanup__();
+
+		ptr = dyingObj.ptr;
+		refCount = dyingObj.refCount;
+
+		dyingObj.ptr = nullptr;
+		dyingObj.refCount = nullptr;
+		return *this;
+	}
+
+	void swap(my_weak_ptr& obj) noexcept {
+		std::swap(ptr, obj.ptr);
+		std::swap(refCount, obj.refCount);
+	}
+
+	uint use_count() const {
+		return refCount != nullptr ? refCount->use_count() : 0;
+	}
+
+	bool expired() const {
+		return use_count() == 0;
+	}
+
+	// empty pointer if the object is already gone
+	my_shared_ptr<T, Policy> lock() const {
+		if (refCount != nullptr && refCount->add_ref_if_alive())
+			return my_shared_ptr<T, Policy>(ptr, refCount);
+		return my_shared_ptr<T, Policy>();
+	}
+
+	void reset() {
+		my_weak_ptr().swap(*this);
+	}
+
+	~my_weak_ptr() {
+		__cleanup__();
+	}
+
+private:
+	void __cleanup__() {
+		if (refCount != nullptr)
+			refCount->release_weak();
+	}
+};
+
+template<class T, my_lock_policy Policy>
+void swap(my_weak_ptr<T, Policy>& a, my_weak_ptr<T, Policy>& b) noexcept {
+	a.swap(b);
+}
+
+template<class T, my_lock_policy Policy>
+struct my_is_trivially_relocatable<my_weak_ptr<T, Policy>> : std::true_type { };
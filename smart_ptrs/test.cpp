@@ -0,0 +1,800 @@
+// Checks of the my_* smart pointers that the benchmark doesn't make: reference counts
+// and object lifetimes. Prints every failed check and exits with 1 if there was one.
+// Built with AddressSanitizer: LeakSanitizer also fails the run if anything leaks.
+//
+//     make test
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <set>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "my_shared_ptr.hpp"
+#include "my_weak_ptr.hpp"
+#include "my_intrusive_ptr.hpp"
+#include "my_unique_ptr.hpp"
+#include "my_small_vector.hpp"
+#include "my_pool_allocator.hpp"
+
+static int gFailures = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			gFailures++; \
+		} \
+	} while (false)
+
+// Heap allocations still alive; the next one can be made to fail
+static std::atomic<long> gLiveAllocations {0};
+static bool gFailNextAllocation = false;
+
+void* operator new(std::size_t size) {
+	if (gFailNextAllocation) {
+		gFailNextAllocation = false;
+		throw std::bad_alloc();
+	}
+	void* p = std::malloc(size);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	gLiveAllocations++;
+	return p;
+}
+
+// my_make_shared_padded blocks are cache line aligned
+void* operator new(std::size_t size, std::align_val_t align) {
+	void* p = std::aligned_alloc(std::size_t(align), (size + std::size_t(align) - 1) / std::size_t(align) * std::size_t(align));
+	if (p == nullptr)
+		throw std::bad_alloc();
+	gLiveAllocations++;
+	return p;
+}
+
+void operator delete(void* p) noexcept {
+	if (p != nullptr)
+		gLiveAllocations--;
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	operator delete(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+	operator delete(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+	operator delete(p);
+}
+
+
+// Counts its destructions
+struct Tracked {
+	static inline std::atomic<int> destroyed {0};
+
+	int value;
+
+	explicit Tracked(int value) : value(value) { }
+
+	virtual ~Tracked() {
+		destroyed++;
+	}
+};
+
+
+// Threads copy and destroy owners of one object at the same time.
+// No increment or decrement may be lost and the object must die exactly once.
+static void concurrentCopyTest() {
+	const unsigned threadCount = std::max(4u, std::thread::hardware_concurrency());
+	const int copiesPerThread = 200000;
+	Tracked::destroyed = 0;
+
+	my_shared_ptr<Tracked, my_lock_policy::atomic> source(new Tracked(1));
+	std::vector<std::thread> threads;
+	for (unsigned t = 0; t < threadCount; t++) {
+		threads.emplace_back([&source, copiesPerThread] {
+			my_shared_ptr<Tracked, my_lock_policy::atomic> kept;
+			for (int i = 0; i < copiesPerThread; i++) {
+				my_shared_ptr<Tracked, my_lock_policy::atomic> copy(source);
+				kept = copy;
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+
+	CHECK(source.get_count() == 1);
+	CHECK(Tracked::destroyed == 0);
+	source.reset();
+	CHECK(Tracked::destroyed == 1);
+}
+
+
+// The adopted object must not leak when its control block can't be allocated
+static void failedBlockAllocationTest() {
+	Tracked::destroyed = 0;
+	long allocations = gLiveAllocations;
+	Tracked* raw = new Tracked(1);
+
+	bool isThrown = false;
+	gFailNextAllocation = true;
+	try {
+		my_shared_ptr<Tracked> p(raw);
+	}
+	catch (const std::bad_alloc&) {
+		isThrown = true;
+	}
+	CHECK(isThrown);
+	CHECK(Tracked::destroyed == 1);
+	CHECK(gLiveAllocations == allocations);
+}
+
+
+// Parent owns the child, the child only observes the parent: dropping the parent frees both
+struct TreeNode : Tracked {
+	my_shared_ptr<TreeNode> child;
+	my_weak_ptr<TreeNode> parent;
+
+	using Tracked::Tracked;
+};
+
+static void weakBackLinkTest() {
+	Tracked::destroyed = 0;
+	long allocations = gLiveAllocations;
+	{
+		my_shared_ptr<TreeNode> parent(new TreeNode(1));
+		my_shared_ptr<TreeNode> child(new TreeNode(2));
+		parent->child = child;
+		child->parent = parent;
+		CHECK(child->parent.lock().get() == parent.get());
+		CHECK(parent.get_count() == 1);
+		CHECK(child.get_count() == 2);
+	}
+	CHECK(Tracked::destroyed == 2);
+	CHECK(gLiveAllocations == allocations);
+}
+
+static void expiredTest() {
+	my_shared_ptr<Tracked> strong(new Tracked(1));
+	my_shared_ptr<Tracked> other = strong;
+	my_weak_ptr<Tracked> weak(strong);
+	CHECK(!weak.expired());
+	strong.reset();
+	CHECK(!weak.expired());
+	other.reset();
+	CHECK(weak.expired());
+	CHECK(weak.use_count() == 0);
+}
+
+static void lockAfterDestructionTest() {
+	Tracked::destroyed = 0;
+	my_weak_ptr<Tracked> weak;
+	{
+		my_shared_ptr<Tracked> strong(new Tracked(1));
+		weak = strong;
+		my_shared_ptr<Tracked> locked = weak.lock();
+		CHECK(locked.get() == strong.get());
+		CHECK(strong.get_count() == 2);
+	}
+	CHECK(Tracked::destroyed == 1);
+	my_shared_ptr<Tracked> locked = weak.lock();
+	CHECK(!locked);
+	CHECK(locked.get_count() == 0);
+}
+
+// The object dies with the last strong owner, its control block only with the last weak one
+static void controlBlockLifetimeTest() {
+	Tracked::destroyed = 0;
+	long allocations = gLiveAllocations;
+
+	my_shared_ptr<Tracked> strong(new Tracked(1));
+	my_weak_ptr<Tracked> weak(strong);
+	my_weak_ptr<Tracked> otherWeak = weak;
+	CHECK(gLiveAllocations == allocations + 2);
+	strong.reset();
+	CHECK(Tracked::destroyed == 1);
+	CHECK(gLiveAllocations == allocations + 1);
+	weak.reset();
+	CHECK(gLiveAllocations == allocations + 1);
+	otherWeak.reset();
+	CHECK(gLiveAllocations == allocations);
+
+	// with my_make_shared the object's memory is in the block, so it stays too
+	my_shared_ptr<Tracked> inplace = my_make_shared<Tracked>(2);
+	weak = inplace;
+	CHECK(gLiveAllocations == allocations + 1);
+	inplace.reset();
+	CHECK(Tracked::destroyed == 2);
+	CHECK(gLiveAllocations == allocations + 1);
+	weak.reset();
+	CHECK(gLiveAllocations == allocations);
+
+	// the padded block is the same apart from its alignment
+	my_shared_ptr<Tracked> padded = my_make_shared_padded<Tracked>(3);
+	weak = padded;
+	CHECK(gLiveAllocations == allocations + 1);
+	padded.reset();
+	CHECK(Tracked::destroyed == 3);
+	CHECK(gLiveAllocations == allocations + 1);
+	weak.reset();
+	CHECK(gLiveAllocations == allocations);
+}
+
+
+// Assigning from a pointer that only the old pointee keeps alive, like stepping along a list
+struct ListNode : Tracked {
+	my_shared_ptr<ListNode> next;
+
+	using Tracked::Tracked;
+};
+
+static void assignFromPointeeTest() {
+	Tracked::destroyed = 0;
+	my_shared_ptr<ListNode> head(new ListNode(1));
+	head->next = my_shared_ptr<ListNode>(new ListNode(2));
+	head->next->next = my_shared_ptr<ListNode>(new ListNode(3));
+
+	head = head->next;
+	CHECK(Tracked::destroyed == 1);
+	CHECK(head->value == 2);
+	CHECK(head.get_count() == 1);
+
+	head = std::move(head->next);
+	CHECK(Tracked::destroyed == 2);
+	CHECK(head->value == 3);
+	CHECK(head.get_count() == 1);
+
+	my_shared_ptr<ListNode>& self = head;
+	head = self;
+	head = std::move(self);
+	CHECK(head->value == 3);
+	CHECK(head.get_count() == 1);
+	head.reset();
+	CHECK(Tracked::destroyed == 3);
+}
+
+struct Holder : Tracked {
+	int member = 5;
+
+	using Tracked::Tracked;
+};
+
+// An aliased pointer points into the owner but shares its count and keeps it alive
+static void aliasingTest() {
+	Tracked::destroyed = 0;
+	my_shared_ptr<Holder> owner(new Holder(1));
+	my_shared_ptr<int> alias(owner, &owner->member);
+	CHECK(alias.get() == &owner->member);
+	CHECK(owner.get_count() == 2);
+	CHECK(alias.get_count() == 2);
+
+	owner.reset();
+	CHECK(Tracked::destroyed == 0);
+	CHECK(alias.get_count() == 1);
+	CHECK(*alias == 5);
+	alias.reset();
+	CHECK(Tracked::destroyed == 1);
+}
+
+struct Derived : Tracked {
+	using Tracked::Tracked;
+};
+
+struct Unrelated : Tracked {
+	using Tracked::Tracked;
+};
+
+static void pointerCastTest() {
+	my_shared_ptr<Tracked> base(new Derived(1));
+
+	my_shared_ptr<Unrelated> failed = my_dynamic_pointer_cast<Unrelated>(base);
+	CHECK(!failed);
+	CHECK(failed.get_count() == 0);
+	CHECK(base.get_count() == 1);
+
+	my_shared_ptr<Derived> derived = my_dynamic_pointer_cast<Derived>(base);
+	CHECK(derived.get() == base.get());
+	CHECK(base.get_count() == 2);
+
+	my_shared_ptr<Derived> same = my_static_pointer_cast<Derived>(base);
+	CHECK(same.get() == base.get());
+	CHECK(base.get_count() == 3);
+
+	my_shared_ptr<const Tracked> constant = base;
+	my_shared_ptr<Tracked> mutableAgain = my_const_pointer_cast<Tracked>(constant);
+	CHECK(mutableAgain.get() == base.get());
+	CHECK(base.get_count() == 5);
+}
+
+
+// Counted in the object itself. The base's destructor is protected and not virtual,
+// release() deletes through RefNode, whose destructor (from Tracked) is virtual.
+struct RefNode : Tracked, my_ref_counted<RefNode> {
+	my_intrusive_ptr<RefNode> next;
+
+	using Tracked::Tracked;
+};
+
+struct RefLeaf : RefNode {
+	static inline int leafDestroyed = 0;
+
+	using RefNode::RefNode;
+
+	~RefLeaf() {
+		leafDestroyed++;
+	}
+};
+
+static_assert(!std::is_destructible<my_ref_counted<RefNode>>::value, "only T may destroy itself");
+
+static void intrusiveAdoptTest() {
+	Tracked::destroyed = 0;
+
+	// addRef = false takes over the reference the caller made
+	RefNode* raw = new RefNode(1);
+	raw->add_ref();
+	my_intrusive_ptr<RefNode> adopted(raw, false);
+	CHECK(adopted.get_count() == 1);
+
+	// addRef = true makes another owner from the raw pointer
+	my_intrusive_ptr<RefNode> shared(raw);
+	CHECK(adopted.get_count() == 2);
+	shared.reset();
+	CHECK(adopted.get_count() == 1);
+	CHECK(Tracked::destroyed == 0);
+	adopted.reset();
+	CHECK(Tracked::destroyed == 1);
+}
+
+static void intrusiveAssignTest() {
+	Tracked::destroyed = 0;
+	my_intrusive_ptr<RefNode> head(new RefNode(1));
+	my_intrusive_ptr<RefNode>& self = head;
+	head = self;
+	CHECK(head.get_count() == 1);
+	head = std::move(self);
+	CHECK(head.get_count() == 1);
+	CHECK(Tracked::destroyed == 0);
+
+	// the source is only kept alive by the object being released
+	head->next = my_intrusive_ptr<RefNode>(new RefNode(2));
+	head->next->next = my_intrusive_ptr<RefNode>(new RefNode(3));
+	head = head->next;
+	CHECK(Tracked::destroyed == 1);
+	CHECK(head->value == 2);
+	CHECK(head.get_count() == 1);
+	head = std::move(head->next);
+	CHECK(Tracked::destroyed == 2);
+	CHECK(head->value == 3);
+	head.reset();
+	CHECK(Tracked::destroyed == 3);
+}
+
+static void intrusiveDerivedTest() {
+	Tracked::destroyed = 0;
+	RefLeaf::leafDestroyed = 0;
+	my_intrusive_ptr<RefNode> base(new RefLeaf(1));
+	my_intrusive_ptr<RefNode> copy = base;
+	base.reset();
+	CHECK(RefLeaf::leafDestroyed == 0);
+	copy.reset();
+	CHECK(RefLeaf::leafDestroyed == 1);
+	CHECK(Tracked::destroyed == 1);
+}
+
+static_assert(sizeof(my_unique_ptr<int>) == sizeof(int*), "default deleter must not take space");
+static_assert(sizeof(my_unique_ptr<int, void(*)(int*)>) == 2 * sizeof(int*), "function pointer deleter is stored");
+static_assert(sizeof(my_unique_ptr<int[]>) == sizeof(int*), "default array deleter must not take space");
+
+// Stateful deleter: counts its calls through the pointer it carries
+struct CountingDeleter {
+	int* calls;
+
+	void operator()(Tracked* p) const {
+		(*calls)++;
+		delete p;
+	}
+};
+
+static void uniqueStatefulDeleterTest() {
+	Tracked::destroyed = 0;
+	int calls = 0;
+	{
+		my_unique_ptr<Tracked, CountingDeleter> first(new Tracked(1), CountingDeleter{&calls});
+		my_unique_ptr<Tracked, CountingDeleter> second(std::move(first));
+		CHECK(!first);
+		CHECK(second.get_deleter().calls == &calls);
+		my_unique_ptr<Tracked, CountingDeleter> third(nullptr, CountingDeleter{nullptr});
+		third = std::move(second);
+		CHECK(third.get_deleter().calls == &calls);
+		CHECK(calls == 0);
+	}
+	CHECK(calls == 1);
+	CHECK(Tracked::destroyed == 1);
+
+	my_unique_ptr<Tracked, CountingDeleter> owner(new Tracked(2), CountingDeleter{&calls});
+	owner.reset(new Tracked(3));
+	CHECK(calls == 2);
+	CHECK(owner->value == 3);
+	owner.reset();
+	CHECK(calls == 3);
+	owner.reset();
+	CHECK(calls == 3);
+	CHECK(Tracked::destroyed == 3);
+}
+
+static int gFunctionDeleterCalls = 0;
+
+static void deleteTracked(Tracked* p) {
+	gFunctionDeleterCalls++;
+	delete p;
+}
+
+static void uniqueFunctionDeleterTest() {
+	Tracked::destroyed = 0;
+	gFunctionDeleterCalls = 0;
+	{
+		my_unique_ptr<Tracked, void(*)(Tracked*)> owner(new Tracked(1), deleteTracked);
+		my_unique_ptr<Tracked, void(*)(Tracked*)> moved(std::move(owner));
+		CHECK(moved.get_deleter() == deleteTracked);
+	}
+	CHECK(gFunctionDeleterCalls == 1);
+	CHECK(Tracked::destroyed == 1);
+}
+
+// After release() the caller owns the object: the deleter must never see it
+static void uniqueReleaseTest() {
+	Tracked::destroyed = 0;
+	int calls = 0;
+	Tracked* raw;
+	{
+		my_unique_ptr<Tracked, CountingDeleter> owner(new Tracked(1), CountingDeleter{&calls});
+		raw = owner.release();
+		CHECK(!owner);
+		CHECK(owner.get() == nullptr);
+	}
+	CHECK(calls == 0);
+	CHECK(Tracked::destroyed == 0);
+	delete raw;
+	CHECK(Tracked::destroyed == 1);
+}
+
+// Array elements count themselves, so a delete[] that misses or repeats elements shows up
+struct ArrayElement {
+	static inline int constructed = 0;
+	static inline int destroyed = 0;
+
+	int value = 7;
+
+	ArrayElement() {
+		constructed++;
+	}
+
+	~ArrayElement() {
+		destroyed++;
+	}
+};
+
+static void uniqueArrayTest() {
+	ArrayElement::constructed = 0;
+	ArrayElement::destroyed = 0;
+	{
+		my_unique_ptr<ArrayElement[]> elements = my_make_unique_for_overwrite<ArrayElement[]>(7);
+		CHECK(ArrayElement::constructed == 7);
+		CHECK(elements[6].value == 7);
+
+		elements.reset(new ArrayElement[3]);
+		CHECK(ArrayElement::destroyed == 7);
+		CHECK(elements[2].value == 7);
+
+		ArrayElement* raw = elements.release();
+		CHECK(!elements);
+		elements.reset();
+		CHECK(ArrayElement::destroyed == 7);
+		delete[] raw;
+		CHECK(ArrayElement::destroyed == 10);
+
+		elements = my_make_unique<ArrayElement[]>(5);
+		my_unique_ptr<ArrayElement[]> moved(std::move(elements));
+		CHECK(!elements);
+		CHECK(ArrayElement::destroyed == 10);
+	}
+	CHECK(ArrayElement::constructed == 15);
+	CHECK(ArrayElement::destroyed == 15);
+
+	// trivial elements: the whole buffer is writable, and freed with delete[]
+	my_unique_ptr<int[]> buffer = my_make_unique_for_overwrite<int[]>(1000);
+	for (int i = 0; i < 1000; i++)
+		buffer[i] = i;
+	CHECK(buffer[999] == 999);
+	my_unique_ptr<int[]> zeroed = my_make_unique<int[]>(1000);
+	CHECK(zeroed[0] == 0 && zeroed[999] == 0);
+	buffer.reset();
+	CHECK(!buffer);
+}
+
+// Growing moves my_shared_ptr elements with one memcpy: the counts must come out unchanged
+// and every object must still be destroyed exactly once
+static_assert(my_is_trivially_relocatable_v<my_shared_ptr<Tracked>>, "grows by memcpy");
+
+static void smallVectorRelocateTest() {
+	Tracked::destroyed = 0;
+	long allocations = gLiveAllocations;
+	{
+		std::vector<my_shared_ptr<Tracked>> sources;
+		for (int i = 0; i < 20; i++)
+			sources.push_back(my_shared_ptr<Tracked>(new Tracked(i)));
+
+		my_small_vector<my_shared_ptr<Tracked>, 4> ptrs;
+		for (const my_shared_ptr<Tracked>& source : sources)
+			ptrs.push_back(source);
+		CHECK(ptrs.capacity() > 4);
+		for (int i = 0; i < 20; i++) {
+			CHECK(ptrs[i].get() == sources[i].get());
+			CHECK(sources[i].get_count() == 2);
+		}
+
+		// moving a heap vector steals the buffer
+		my_small_vector<my_shared_ptr<Tracked>, 4> moved(std::move(ptrs));
+		CHECK(ptrs.empty());
+		CHECK(moved.size() == 20);
+		CHECK(sources[19].get_count() == 2);
+
+		moved.clear();
+		for (const my_shared_ptr<Tracked>& source : sources)
+			CHECK(source.get_count() == 1);
+		CHECK(Tracked::destroyed == 0);
+	}
+	CHECK(Tracked::destroyed == 20);
+	CHECK(gLiveAllocations == allocations);
+}
+
+// Keeps a pointer to itself, so a memcpy would leave it pointing at the old place
+struct SelfPointing {
+	static inline int moves = 0;
+	static inline int destroyed = 0;
+	static inline int misplaced = 0;
+
+	SelfPointing* self;
+	int value;
+
+	explicit SelfPointing(int value) : self(this), value(value) { }
+
+	SelfPointing(const SelfPointing& obj) : self(this), value(obj.value) { }
+
+	SelfPointing(SelfPointing&& dyingObj) noexcept : self(this), value(dyingObj.value) {
+		moves++;
+	}
+
+	~SelfPointing() {
+		if (self != this)
+			misplaced++;
+		destroyed++;
+	}
+};
+
+static_assert(!my_is_trivially_relocatable_v<SelfPointing>, "grows by moving");
+
+static void smallVectorMoveTest() {
+	SelfPointing::moves = 0;
+	SelfPointing::destroyed = 0;
+	SelfPointing::misplaced = 0;
+	{
+		my_small_vector<SelfPointing, 4> elements;
+		for (int i = 0; i < 4; i++)
+			elements.emplace_back(i);
+		CHECK(SelfPointing::moves == 0);
+
+		// growing past the inline storage moves the 4 elements out, then builds the 5th
+		elements.emplace_back(4);
+		CHECK(SelfPointing::moves == 5);
+		CHECK(SelfPointing::destroyed == 5);
+		for (int i = 0; i < 5; i++) {
+			CHECK(elements[i].self == &elements[i]);
+			CHECK(elements[i].value == i);
+		}
+	}
+	CHECK(SelfPointing::destroyed == 10);
+	CHECK(SelfPointing::misplaced == 0);
+}
+
+// Elements are destroyed once whether they sit inline or on the heap, and the heap buffer is freed
+static void smallVectorDestructionTest() {
+	long allocations = gLiveAllocations;
+	SelfPointing::destroyed = 0;
+	{
+		my_small_vector<SelfPointing, 4> inlineElements;
+		for (int i = 0; i < 3; i++)
+			inlineElements.emplace_back(i);
+		CHECK(gLiveAllocations == allocations);
+
+		// moving an inline vector relocates its elements one by one
+		my_small_vector<SelfPointing, 4> moved(std::move(inlineElements));
+		CHECK(inlineElements.empty());
+		CHECK(SelfPointing::destroyed == 3);
+		CHECK(moved[2].self == &moved[2]);
+	}
+	CHECK(SelfPointing::destroyed == 6);
+
+	SelfPointing::destroyed = 0;
+	{
+		my_small_vector<SelfPointing, 4> heapElements;
+		heapElements.reserve(20);
+		for (int i = 0; i < 20; i++)
+			heapElements.emplace_back(i);
+		CHECK(gLiveAllocations == allocations + 1);
+		heapElements.pop_back();
+		CHECK(SelfPointing::destroyed == 1);
+	}
+	CHECK(SelfPointing::destroyed == 20);
+	CHECK(SelfPointing::misplaced == 0);
+	CHECK(gLiveAllocations == allocations);
+}
+
+// Every pool test uses its own block size, so it starts with empty freelists and shared stack.
+// Blocks are filled with a byte of their own and checked later: a block handed out twice
+// would have been overwritten.
+template<class Pool>
+static std::vector<void*> allocateMarked(std::size_t count, unsigned char mark) {
+	std::vector<void*> blocks;
+	blocks.reserve(count);
+	for (std::size_t i = 0; i < count; i++) {
+		void* p = Pool::allocate();
+		std::memset(p, mark, 48);
+		blocks.push_back(p);
+	}
+	return blocks;
+}
+
+static bool isMarked(const std::vector<void*>& blocks, unsigned char mark) {
+	for (void* p : blocks) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(p);
+		if (std::count(bytes, bytes + 48, mark) != 48)
+			return false;
+	}
+	return true;
+}
+
+// One thread allocates, another frees: the blocks go back through the shared stack
+// and the next thread that runs dry gets them, without a new chunk
+static void poolCrossThreadFreeTest() {
+	typedef my_fixed_pool<48, 8> pool;
+	// whole chunks of 256, so the producer has no blocks left over
+	const std::size_t count = 12 * 256;
+
+	std::vector<void*> blocks;
+	std::thread producer([&blocks, count] {
+		blocks = allocateMarked<pool>(count, 1);
+	});
+	producer.join();
+	CHECK(isMarked(blocks, 1));
+	CHECK(std::set<void*>(blocks.begin(), blocks.end()).size() == count);
+
+	std::thread consumer([&blocks] {
+		for (void* p : blocks)
+			pool::deallocate(p);
+	});
+	consumer.join();
+
+	// only the vector of results is allocated
+	long allocations = gLiveAllocations;
+	std::vector<void*> reused = allocateMarked<pool>(count, 2);
+	CHECK(gLiveAllocations == allocations + 1);
+	CHECK(std::set<void*>(reused.begin(), reused.end()) == std::set<void*>(blocks.begin(), blocks.end()));
+	CHECK(isMarked(reused, 2));
+	for (void* p : reused)
+		pool::deallocate(p);
+}
+
+// A thread that drained the shared stack owns those blocks alone: it can free and reuse them
+// while another thread, finding the stack empty, gets fresh ones
+static void poolReuseAfterDrainTest() {
+	typedef my_fixed_pool<56, 8> pool;
+	const std::size_t count = 100;
+
+	std::thread giver([count] {
+		std::vector<void*> blocks = allocateMarked<pool>(count, 1);
+		for (void* p : blocks)
+			pool::deallocate(p);
+	});
+	giver.join();
+
+	void* first = pool::allocate();
+	pool::deallocate(first);
+	void* again = pool::allocate();
+	CHECK(again == first);
+	std::vector<void*> mine = allocateMarked<pool>(count, 3);
+	mine.push_back(again);
+	std::memset(again, 3, 48);
+
+	std::vector<void*> theirs;
+	std::thread other([&theirs, count] {
+		theirs = allocateMarked<pool>(count, 4);
+	});
+	other.join();
+
+	std::set<void*> all(mine.begin(), mine.end());
+	all.insert(theirs.begin(), theirs.end());
+	CHECK(all.size() == mine.size() + theirs.size());
+	CHECK(isMarked(mine, 3));
+	CHECK(isMarked(theirs, 4));
+	for (void* p : mine)
+		pool::deallocate(p);
+	for (void* p : theirs)
+		pool::deallocate(p);
+}
+
+// A pooled block outlives its object while weak owners remain, then goes back to the pool
+struct PoolPayload : Tracked {
+	char padding[40];
+
+	using Tracked::Tracked;
+};
+
+static void allocateSharedPoolTest() {
+	Tracked::destroyed = 0;
+	long allocations = gLiveAllocations;
+
+	my_shared_ptr<PoolPayload> strong = my_allocate_shared<PoolPayload>(my_pool_allocator<PoolPayload>(), 1);
+	PoolPayload* address = strong.get();
+	my_shared_ptr<PoolPayload> copy = strong;
+	my_weak_ptr<PoolPayload> weak(strong);
+	strong.reset();
+	CHECK(Tracked::destroyed == 0);
+	copy.reset();
+	CHECK(Tracked::destroyed == 1);
+	CHECK(!weak.lock());
+	weak.reset();
+	CHECK(Tracked::destroyed == 1);
+
+	// the freed block is the first one handed out again
+	my_shared_ptr<PoolPayload> next = my_allocate_shared<PoolPayload>(my_pool_allocator<PoolPayload>(), 2);
+	CHECK(next.get() == address);
+	CHECK(next->value == 2);
+	next.reset();
+	CHECK(Tracked::destroyed == 2);
+
+	// the pool keeps its first chunk, nothing else stays allocated
+	CHECK(gLiveAllocations == allocations + 1);
+}
+
+int main() {
+	concurrentCopyTest();
+	failedBlockAllocationTest();
+	weakBackLinkTest();
+	expiredTest();
+	lockAfterDestructionTest();
+	controlBlockLifetimeTest();
+	assignFromPointeeTest();
+	aliasingTest();
+	pointerCastTest();
+	intrusiveAdoptTest();
+	intrusiveAssignTest();
+	intrusiveDerivedTest();
+	uniqueStatefulDeleterTest();
+	uniqueFunctionDeleterTest();
+	uniqueReleaseTest();
+	uniqueArrayTest();
+	smallVectorRelocateTest();
+	smallVectorMoveTest();
+	smallVectorDestructionTest();
+	poolCrossThreadFreeTest();
+	poolReuseAfterDrainTest();
+	allocateSharedPoolTest();
+
+	if (gFailures != 0)
+		std::printf("%d checks failed\n", gFailures);
+	else
+		std::printf("All checks passed\n");
+	// LeakSanitizer reports at exit and ends the process without flushing stdout
+	std::fflush(stdout);
+	return gFailures != 0 ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+
+// Bounding volume hierarchy over rects that never move (level blocks).
+// Built once, top-down, by splitting on the median centre along the longer axis;
+// nodes live in one flat array with the left child right after its parent.
+// A rect is identified by its index in the vector the tree was built from.
+class StaticAabbTree
+{
+public:
+
+    void build(const std::vector<sf::FloatRect>& rects)
+    {
+        mRects = rects;
+        mNodes.clear();
+        mIndices.resize(rects.size());
+        for (size_t i = 0; i < rects.size(); i++)
+            mIndices[i] = static_cast<std::uint32_t>(i);
+
+        if (!rects.empty())
+        {
+            mNodes.reserve(2 * rects.size() / kMaxLeafSize + 1);
+            buildNode(0, static_cast<std::uint32_t>(rects.size()));
+        }
+    }
+
+    // Appends indices of all rects overlapping area (touching counts) to result, in ascending order
+    void query(const sf::FloatRect& area, std::vector<size_t>& result) const
+    {
+        if (mNodes.empty())
+            return;
+
+        size_t first = result.size();
+        std::uint32_t stack[64];
+        int stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0)
+        {
+            const Node& node = mNodes[stack[--stackSize]];
+            if (!overlaps(node.bounds, area))
+                continue;
+
+            if (node.count > 0)
+            {
+                for (std::uint32_t i = node.first; i < node.first + node.count; i++)
+                {
+                    if (overlaps(mRects[mIndices[i]], area))
+                        result.push_back(mIndices[i]);
+                }
+            }
+            else
+            {
+                stack[stackSize++] = node.first;
+                stack[stackSize++] = node.first + 1 + mNodes[node.first].subtreeSize;
+            }
+        }
+        std::sort(result.begin() + first, result.end());
+    }
+
+    size_t size() const
+    {
+        return mRects.size();
+    }
+
+private:
+
+    struct Node
+    {
+        sf::FloatRect bounds;
+        std::uint32_t first;        // leaf: first entry in mIndices, inner node: left child
+        std::uint32_t count;        // number of rects in a leaf, 0 for inner nodes
+        std::uint32_t subtreeSize;  // nodes below this one, locates the right child
+    };
+
+    static constexpr std::uint32_t kMaxLeafSize = 4;
+
+    static bool overlaps(const sf::FloatRect& a, const sf::FloatRect& b)
+    {
+        return a.left + a.width >= b.left && b.left + b.width >= a.left
+            && a.top + a.height >= b.top && b.top + b.height >= a.top;
+    }
+
+    static sf::FloatRect merge(const sf::FloatRect& a, const sf::FloatRect& b)
+    {
+        float left = std::min(a.left, b.left);
+        float top = std::min(a.top, b.top);
+        float right = std::max(a.left + a.width, b.left + b.width);
+        float bottom = std::max(a.top + a.height, b.top + b.height);
+        return {left, top, right - left, bottom - top};
+    }
+
+    // builds the subtree for mIndices[begin, end) and returns the index of its root
+    std::uint32_t buildNode(std::uint32_t begin, std::uint32_t end)
+    {
+        std::uint32_t nodeIndex = static_cast<std::uint32_t>(mNodes.size());
+        mNodes.push_back({});
+
+        sf::FloatRect bounds = mRects[mIndices[begin]];
+        for (std::uint32_t i = begin + 1; i < end; i++)
+            bounds = merge(bounds, mRects[mIndices[i]]);
+
+        if (end - begin <= kMaxLeafSize)
+        {
+            mNodes[nodeIndex] = {bounds, begin, end - begin, 0};
+            return nodeIndex;
+        }
+
+        bool splitX = bounds.width >= bounds.height;
+        std::uint32_t middle = begin + (end - begin) / 2;
+        std::nth_element(mIndices.begin() + begin, mIndices.begin() + middle, mIndices.begin() + end,
+            [&](std::uint32_t a, std::uint32_t b)
+            {
+                const sf::FloatRect& ra = mRects[a];
+                const sf::FloatRect& rb = mRects[b];
+                if (splitX)
+                    return 2 * ra.left + ra.width < 2 * rb.left + rb.width;
+                return 2 * ra.top + ra.height < 2 * rb.top + rb.height;
+            });
+
+        std::uint32_t left = buildNode(begin, middle);
+        buildNode(middle, end);
+        mNodes[nodeIndex] = {bounds, left, 0, static_cast<std::uint32_t>(mNodes.size()) - nodeIndex - 1};
+        return nodeIndex;
+    }
+
+    std::vector<sf::FloatRect> mRects       {};
+    std::vector<std::uint32_t> mIndices     {};
+    std::vector<Node> mNodes                {};
+};
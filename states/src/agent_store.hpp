@@ -0,0 +1,250 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "animation.hpp"
+#include "input_state.hpp"
+#include "player.hpp"
+#include "player_states.hpp"
+#include "world.hpp"
+#include "aabb_tree.hpp"
+
+
+// A crowd of agents stored as packed components: agent i is entry i of every array.
+// Each system is one pass over the arrays it needs instead of a virtual call per object.
+//
+// Agents run the movement part of Player's state machine (Idle, Running, Falling, Hooked)
+// with the same numbers, so an agent moves exactly like a Player given the same input.
+// They share one InputState and get no events: jumps, slides and attacks need key presses.
+class AgentStore
+{
+public:
+
+    // A new agent is idle, like a new Player, and like it keeps the unscaled rect until its first transition
+    size_t add(sf::Vector2f position)
+    {
+        mPositions.push_back(position);
+        mVelocities.push_back({0, 0});
+        mCollisionRects.push_back(PlayerState::kUprightRect);
+        mStates.push_back(PlayerStateId::Idle);
+        mAnimations.push_back(Animation(getAnimationClip(PlayerStateId::Idle)));
+        return mPositions.size() - 1;
+    }
+
+    void reserve(size_t count)
+    {
+        mPositions.reserve(count);
+        mVelocities.reserve(count);
+        mCollisionRects.reserve(count);
+        mStates.reserve(count);
+        mAnimations.reserve(count);
+    }
+
+    size_t size() const
+    {
+        return mPositions.size();
+    }
+
+    sf::Vector2f getPosition(size_t agent) const
+    {
+        return mPositions[agent];
+    }
+
+    sf::FloatRect getCollisionRect(size_t agent) const
+    {
+        const sf::FloatRect& rect = mCollisionRects[agent];
+        return {mPositions[agent].x + rect.left, mPositions[agent].y + rect.top, rect.width, rect.height};
+    }
+
+    PlayerStateId getState(size_t agent) const
+    {
+        return mStates[agent];
+    }
+
+    const Animation& getAnimation(size_t agent) const
+    {
+        return mAnimations[agent];
+    }
+
+
+    // One tick, in the order World::update runs it for the player.
+    // blocks is the tree built from blockRects.
+    void update(float dt, float gravity, const InputState& input, const StaticAabbTree& blocks, const std::vector<sf::FloatRect>& blockRects)
+    {
+        applyGravity(gravity * dt);
+        animate(dt);
+        updateStates(input);
+        integrate(dt);
+        collide(blocks, blockRects);
+    }
+
+    void applyGravity(float velocityChange)
+    {
+        for (sf::Vector2f& velocity : mVelocities)
+            velocity.y += velocityChange;
+    }
+
+    void animate(float dt)
+    {
+        for (Animation& animation : mAnimations)
+            animation.update(dt);
+    }
+
+    // What PlayerState::update does when only Left and Right can be held
+    void updateStates(const InputState& input)
+    {
+        bool isLeftPressed = input.isKeyPressed(sf::Keyboard::Left);
+        bool isRightPressed = input.isKeyPressed(sf::Keyboard::Right);
+        for (size_t i = 0; i < size(); i++)
+        {
+            switch (mStates[i])
+            {
+                case PlayerStateId::Idle:
+                    if (isLeftPressed || isRightPressed)
+                        enter(i, PlayerStateId::Running);
+                    break;
+                case PlayerStateId::Running:
+                    if (isLeftPressed)
+                        mVelocities[i].x = -Running::kRunningSpeed;
+                    if (isRightPressed)
+                        mVelocities[i].x = Running::kRunningSpeed;
+                    break;
+                case PlayerStateId::Falling:
+                    if (isLeftPressed)
+                        mVelocities[i].x = -Falling::kHorizontalVelocity;
+                    if (isRightPressed)
+                        mVelocities[i].x = Falling::kHorizontalVelocity;
+                    break;
+                case PlayerStateId::Hooked:
+                    mVelocities[i] = {0, 0};
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    void integrate(float dt)
+    {
+        for (size_t i = 0; i < size(); i++)
+            mPositions[i] += mVelocities[i] * dt;
+    }
+
+    // Player::handleAllCollisions against the blocks near every agent
+    void collide(const StaticAabbTree& blocks, const std::vector<sf::FloatRect>& blockRects)
+    {
+        for (size_t i = 0; i < size(); i++)
+        {
+            sf::FloatRect collisionArea = getCollisionRect(i);
+            collisionArea.left -= World::kCollisionMargin;
+            collisionArea.top -= World::kCollisionMargin;
+            collisionArea.width += 2 * World::kCollisionMargin;
+            collisionArea.height += 2 * World::kCollisionMargin;
+            mNearbyIds.clear();
+            blocks.query(collisionArea, mNearbyIds);
+
+            bool isColliding = false;
+            for (size_t id : mNearbyIds)
+            {
+                if (handleCollision(i, blockRects[id]))
+                    isColliding = true;
+            }
+            if (!isColliding)
+                startFalling(i);
+        }
+    }
+
+private:
+
+    // Player's rect in every movement state once a state was entered with its scale factor set
+    inline static const sf::FloatRect kCollisionRect {
+        Player::kScaleFactor * PlayerState::kUprightRect.left, Player::kScaleFactor * PlayerState::kUprightRect.top,
+        Player::kScaleFactor * PlayerState::kUprightRect.width, Player::kScaleFactor * PlayerState::kUprightRect.height};
+
+    // PlayerState::enter
+    void enter(size_t agent, PlayerStateId state)
+    {
+        mStates[agent] = state;
+        mAnimations[agent] = Animation(getAnimationClip(state));
+        mCollisionRects[agent] = kCollisionRect;
+        if (state == PlayerStateId::Idle)
+            mVelocities[agent] = {0, 0};
+    }
+
+    void hook(size_t agent)
+    {
+        if (mStates[agent] == PlayerStateId::Falling)
+            enter(agent, PlayerStateId::Hooked);
+    }
+
+    void startFalling(size_t agent)
+    {
+        PlayerStateId state = mStates[agent];
+        if (state == PlayerStateId::Idle || state == PlayerStateId::Running || state == PlayerStateId::Hooked)
+            enter(agent, PlayerStateId::Falling);
+    }
+
+    void hitGround(size_t agent)
+    {
+        PlayerStateId state = mStates[agent];
+        if (state == PlayerStateId::Falling || state == PlayerStateId::Hooked)
+            enter(agent, PlayerStateId::Idle);
+    }
+
+    // Player::handleCollision
+    bool handleCollision(size_t agent, const sf::FloatRect& rect)
+    {
+        sf::FloatRect agentRect = getCollisionRect(agent);
+        sf::Vector2f& position = mPositions[agent];
+        sf::Vector2f& velocity = mVelocities[agent];
+
+        float overlapx1 = agentRect.left + agentRect.width - rect.left;
+        float overlapx2 = rect.left + rect.width - agentRect.left;
+        float overlapy1 = agentRect.top + agentRect.height - rect.top;
+        float overlapy2 = rect.top + rect.height - agentRect.top;
+
+        if (overlapx1 < 0 || overlapx2 < 0 || overlapy1 < 0 || overlapy2 < 0)
+            return false;
+
+        int minOverlapDirection = 0;
+        float minOverlap = overlapx1;
+        if (overlapx2 < minOverlap) {minOverlapDirection = 1; minOverlap = overlapx2;}
+        if (overlapy1 < minOverlap) {minOverlapDirection = 2; minOverlap = overlapy1;}
+        if (overlapy2 < minOverlap) {minOverlapDirection = 3; minOverlap = overlapy2;}
+
+        bool isAtHookHeight = agentRect.top < rect.top + Hooked::kMaxHookOffset && agentRect.top > rect.top - Hooked::kMaxHookOffset;
+        switch (minOverlapDirection)
+        {
+            case 0:
+                position.x -= overlapx1 - 1;
+                if (velocity.y > 0 && isAtHookHeight)
+                    hook(agent);
+                break;
+            case 1:
+                position.x += overlapx2 - 1;
+                if (velocity.y > 0 && isAtHookHeight)
+                    hook(agent);
+                break;
+            case 2:
+                position.y -= overlapy1 - 1;
+                velocity.y = 0;
+                hitGround(agent);
+                break;
+            case 3:
+                position.y += overlapy2 - 1;
+                if (velocity.y < 0)
+                    velocity.y = 0;
+                break;
+        }
+        return true;
+    }
+
+
+    std::vector<sf::Vector2f>   mPositions      {};
+    std::vector<sf::Vector2f>   mVelocities     {};
+    std::vector<sf::FloatRect>  mCollisionRects {};     // relative to the position
+    std::vector<PlayerStateId>  mStates         {};
+    std::vector<Animation>      mAnimations     {};
+
+    std::vector<size_t>         mNearbyIds      {};
+};
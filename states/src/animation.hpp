@@ -1,64 +1,91 @@
 #pragma once
 #include <SFML/Graphics.hpp>
-#include <iostream>
-using std::cout, std::endl;
+#include <type_traits>
 
 
+enum class AnimationType {Repeat, OneIteration};
+
+// Texture rect of one frame. sf::IntRect can't be constexpr, so frame tables use this instead
+struct AnimationFrame
+{
+    int left;
+    int top;
+    int width;
+    int height;
+};
+
+// Frames and playback settings of one animation, defined once as a constant table
+struct AnimationClip
+{
+    const AnimationFrame*   frames;
+    int                     frameCount;
+    float                   speed;
+    AnimationType           type;
+};
+
+template<size_t N>
+constexpr AnimationClip makeAnimationClip(const AnimationFrame (&frames)[N], float speed, AnimationType type = AnimationType::Repeat)
+{
+    return {frames, static_cast<int>(N), speed, type};
+}
+
+
+// Plays a clip: only the clip pointer, time and current frame are stored,
+// so copying an animation or switching it to another clip is free
 class Animation
 {
 public:
-    enum class AnimationType {Repeat, OneIteration};
 
-    Animation(AnimationType type = AnimationType::Repeat) : mType{type}
-    {
-    }
+    Animation() = default;
 
-    void addTextureRect(sf::IntRect rect)
+    explicit Animation(const AnimationClip& clip) : mpClip{&clip}
     {
-        mTextureRects.push_back(rect);
     }
 
-    void setAnimationSpeed(float animationSpeed)
+    // Starts the animation over from the first frame
+    void reset()
     {
-        mAnimationSpeed = animationSpeed;
+        mCurrentFrame = 0;
+        mTime = 0;
     }
 
-    sf::Vector2i getSize()
+    sf::Vector2i getSize() const
     {
-        return {mTextureRects[mCurrentFrame].width, mTextureRects[mCurrentFrame].height};
+        const AnimationFrame& frame = mpClip->frames[mCurrentFrame];
+        return {frame.width, frame.height};
     }
 
     void update(float dt)
     {
         mTime += dt;
-        mCurrentFrame = static_cast<int>(mAnimationSpeed * mTime);
+        mCurrentFrame = static_cast<int>(mpClip->speed * mTime);
 
-        if (mCurrentFrame >= mTextureRects.size())
+        if (mCurrentFrame >= mpClip->frameCount)
         {
-            if (mType == AnimationType::Repeat)
+            if (mpClip->type == AnimationType::Repeat)
             {
                 mCurrentFrame = 0;
                 mTime = 0;
             }
-            else if (mType == AnimationType::OneIteration)
+            else if (mpClip->type == AnimationType::OneIteration)
             {
-                mCurrentFrame = mTextureRects.size() - 1;
-                mTime = mCurrentFrame / mAnimationSpeed;
+                mCurrentFrame = mpClip->frameCount - 1;
+                mTime = mCurrentFrame / mpClip->speed;
             }
         }
     }
 
     void updateSprite(sf::Sprite& sprite) const
     {
-        sprite.setTextureRect(mTextureRects[mCurrentFrame]);
+        const AnimationFrame& frame = mpClip->frames[mCurrentFrame];
+        sprite.setTextureRect({frame.left, frame.top, frame.width, frame.height});
     }
 
 private:
 
-    std::vector<sf::IntRect>    mTextureRects  {};
-    
-    int             mCurrentFrame   {0};
-    float           mAnimationSpeed {1};
-    float           mTime           {0};
-    AnimationType   mType           {AnimationType::OneIteration};
-};
\ No newline at end of file
+    const AnimationClip*    mpClip          {nullptr};
+    int                     mCurrentFrame   {0};
+    float                   mTime           {0};
+};
+
+static_assert(std::is_trivially_copyable<Animation>::value, "Animation is meant to be stored in packed arrays");
\ No newline at end of file
@@ -0,0 +1,422 @@
+// Benchmarks of World's collision handling on large generated levels, of player state transitions
+// and of crowds of agents.
+// Nothing here opens a window or loads textures, so it runs on a headless box:
+//     make bench && ./bench
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+#include "spatial_grid.hpp"
+#include "aabb_tree.hpp"
+#include "overlap_kernel.hpp"
+#include "slot_map.hpp"
+#include "player.hpp"
+#include "level.hpp"
+#include "agent_store.hpp"
+
+using std::cout, std::endl;
+
+
+// Counts every heap allocation the program makes
+static size_t sAllocationCount = 0;
+
+void* operator new(size_t size)
+{
+    sAllocationCount++;
+    if (void* p = std::malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+
+// Same overlap test as Player::handleCollision and Player::handleAttackCollision
+static bool overlaps(const sf::FloatRect& a, const sf::FloatRect& b)
+{
+    return a.left + a.width - b.left >= 0 && b.left + b.width - a.left >= 0
+        && a.top + a.height - b.top >= 0 && b.top + b.height - a.top >= 0;
+}
+
+// Player-sized rect crossing the level, one position per frame
+static std::vector<sf::FloatRect> generatePath(size_t frames, float levelWidth)
+{
+    std::vector<sf::FloatRect> path;
+    for (size_t i = 0; i < frames; i++)
+    {
+        float t = static_cast<float>(i) / frames;
+        path.push_back({t * levelWidth, 1500 * std::sin(t * 40), 80, 120});
+    }
+    return path;
+}
+
+static double nsPerFrame(size_t frames, const std::function<size_t(size_t)>& frame)
+{
+    size_t hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < frames; i++)
+        hits += frame(i);
+    auto end = std::chrono::steady_clock::now();
+    // keeps the loop from being optimized away
+    if (hits == static_cast<size_t>(-1))
+        cout << hits;
+    return std::chrono::duration<double, std::nano>(end - start).count() / frames;
+}
+
+static double msSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void broadphaseBenchmark(size_t blockCount)
+{
+    const float levelWidth = blockCount * 20.0f;
+    const size_t frames = 2000;
+    std::vector<sf::FloatRect> blocks = generateBlocks(blockCount, levelWidth);
+    std::vector<sf::FloatRect> path = generatePath(frames, levelWidth);
+
+    cout << std::fixed << std::setprecision(0) << std::setw(8) << blockCount << " blocks:";
+
+    // the full scan is only worth waiting for on smaller levels
+    if (blockCount <= 100000)
+    {
+        double linear = nsPerFrame(frames, [&](size_t i)
+        {
+            size_t hits = 0;
+            for (const sf::FloatRect& block : blocks)
+                hits += overlaps(path[i], block);
+            return hits;
+        });
+        cout << "  linear " << std::setw(9) << linear << " ns/frame";
+    }
+    else
+    {
+        cout << "  linear " << std::setw(9) << "-" << "         ";
+    }
+
+    auto gridStart = std::chrono::steady_clock::now();
+    SpatialGrid<size_t> grid;
+    for (size_t i = 0; i < blocks.size(); i++)
+        grid.insert(i, blocks[i]);
+    double gridBuild = msSince(gridStart);
+
+    std::vector<size_t> nearby;
+    double gridQuery = nsPerFrame(frames, [&](size_t i)
+    {
+        size_t hits = 0;
+        nearby.clear();
+        grid.query(path[i], nearby);
+        for (size_t id : nearby)
+            hits += overlaps(path[i], blocks[id]);
+        return hits;
+    });
+
+    auto treeStart = std::chrono::steady_clock::now();
+    StaticAabbTree tree;
+    tree.build(blocks);
+    double treeBuild = msSince(treeStart);
+
+    double treeQuery = nsPerFrame(frames, [&](size_t i)
+    {
+        nearby.clear();
+        tree.query(path[i], nearby);
+        return nearby.size();
+    });
+
+    cout << std::setprecision(1)
+         << "  grid: build " << std::setw(7) << gridBuild << " ms, query " << std::setw(6) << gridQuery << " ns/frame"
+         << "  bvh: build " << std::setw(7) << treeBuild << " ms, query " << std::setw(6) << treeQuery << " ns/frame" << endl;
+}
+
+
+// Sword rect against every enemy: the AoS loop World used to run vs. the SoA batch kernels
+static void attackBenchmark(size_t enemyCount)
+{
+    const size_t frames = std::max<size_t>(20, 20000000 / enemyCount);
+    std::vector<sf::FloatRect> enemies = generateBlocks(enemyCount, enemyCount * 20.0f);
+    RectArray enemyArray;
+    for (const sf::FloatRect& enemy : enemies)
+        enemyArray.push_back(enemy);
+    std::vector<sf::FloatRect> path = generatePath(frames, enemyCount * 20.0f);
+
+    double loop = nsPerFrame(frames, [&](size_t i)
+    {
+        size_t hits = 0;
+        for (const sf::FloatRect& enemy : enemies)
+            hits += overlaps(path[i], enemy);
+        return hits;
+    });
+    cout << std::fixed << std::setprecision(0) << std::setw(8) << enemyCount << " enemies:  AoS loop " << std::setw(9) << loop << " ns/frame";
+
+    std::vector<std::uint64_t> mask;
+    for (auto [kernel, name] : {std::pair{OverlapKernel::Scalar, "scalar"}, {OverlapKernel::Sse2, "sse2"}, {OverlapKernel::Avx2, "avx2"}})
+    {
+        setOverlapKernel(kernel);
+        if (getOverlapKernel() != kernel)
+            continue;
+        double batch = nsPerFrame(frames, [&](size_t i)
+        {
+            findOverlaps(path[i], enemyArray, mask);
+            return static_cast<size_t>(mask[0]);
+        });
+        cout << "  " << name << " " << std::setw(8) << batch << " ns/frame";
+    }
+    cout << endl;
+}
+
+
+// Every frame 10% of the enemies die and as many respawn.
+// Ordered erase from a vector (what World used to do) vs. RectSlotMap::remove
+static void killBenchmark(size_t enemyCount)
+{
+    const size_t frames = enemyCount >= 100000 ? 5 : 50;
+    const size_t kills = enemyCount / 10;
+    std::vector<sf::FloatRect> spawns = generateBlocks(enemyCount + kills * frames, enemyCount * 20.0f);
+    std::mt19937 random(2);
+
+    std::vector<sf::FloatRect> vector(spawns.begin(), spawns.begin() + enemyCount);
+    size_t nextSpawn = enemyCount;
+    std::vector<size_t> victims;
+    double erase = nsPerFrame(frames, [&](size_t)
+    {
+        // erasing from the back keeps the remaining indices valid
+        victims.clear();
+        for (size_t i = 0; i < kills; i++)
+            victims.push_back(random() % vector.size());
+        std::sort(victims.begin(), victims.end());
+        victims.erase(std::unique(victims.begin(), victims.end()), victims.end());
+        for (auto it = victims.rbegin(); it != victims.rend(); ++it)
+            vector.erase(vector.begin() + *it);
+        for (size_t i = 0; i < victims.size(); i++)
+            vector.push_back(spawns[nextSpawn++]);
+        return vector.size();
+    });
+
+    RectSlotMap slotMap;
+    for (size_t i = 0; i < enemyCount; i++)
+        slotMap.insert(spawns[i]);
+    nextSpawn = enemyCount;
+    std::vector<Handle> handles;
+    double remove = nsPerFrame(frames, [&](size_t)
+    {
+        handles.clear();
+        for (size_t i = 0; i < kills; i++)
+            handles.push_back(slotMap.handleAt(random() % slotMap.size()));
+        // duplicates are stale after the first removal and are skipped
+        for (Handle handle : handles)
+            slotMap.remove(handle);
+        while (slotMap.size() < enemyCount)
+            slotMap.insert(spawns[nextSpawn++]);
+        return slotMap.size();
+    });
+
+    cout << std::fixed << std::setprecision(3) << std::setw(8) << enemyCount << " enemies:  vector erase "
+         << std::setw(10) << erase / 1e6 << " ms/frame  slot map " << std::setw(8) << remove / 1e6 << " ms/frame" << endl;
+}
+
+
+static sf::Event keyEvent(sf::Event::EventType type, sf::Keyboard::Key key)
+{
+    sf::Event event;
+    event.type = type;
+    event.key.code = key;
+    return event;
+}
+
+// Scripted play through every grounded state, driven by events only.
+// One cycle makes 10 transitions:
+// Running, Sliding, Idle, FirstAttack, SecondAttack, Idle, Sitting, Idle, Falling, Idle
+static void transitionBenchmark()
+{
+    const float dt = 1.0f / 60;
+    const size_t cycles = 20000;
+    const size_t transitionsPerCycle = 10;
+
+    Player player({0, 0}, false);
+    InputState input;
+    std::vector<sf::FloatRect> ground(1);
+    std::vector<sf::FloatRect> noEnemies;
+
+    // the player always stands on a block right under its feet
+    auto frames = [&](size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            player.update(dt, input);
+            sf::FloatRect rect = player.getCollisionRect();
+            ground[0] = {rect.left - 100, rect.top + rect.height - 2, rect.width + 200, 100};
+            player.handleAllCollisions(ground, noEnemies);
+        }
+    };
+    auto send = [&](sf::Event::EventType type, sf::Keyboard::Key key)
+    {
+        sf::Event event = keyEvent(type, key);
+        input.handleEvent(event);
+        player.handleEvents(event, input);
+    };
+    auto tap = [&](sf::Keyboard::Key key)
+    {
+        send(sf::Event::KeyPressed, key);
+        send(sf::Event::KeyReleased, key);
+    };
+    const size_t attackFrames = 36;
+
+    auto cycle = [&]()
+    {
+        send(sf::Event::KeyPressed, sf::Keyboard::Right);
+        frames(1);
+        send(sf::Event::KeyPressed, sf::Keyboard::LShift);
+        send(sf::Event::KeyReleased, sf::Keyboard::Right);
+        send(sf::Event::KeyReleased, sf::Keyboard::LShift);
+        frames(attackFrames);
+        tap(sf::Keyboard::X);
+        tap(sf::Keyboard::X);
+        frames(2 * attackFrames);
+        tap(sf::Keyboard::LShift);
+        tap(sf::Keyboard::Space);
+        frames(1);
+    };
+
+    cycle();
+    size_t allocationsBefore = sAllocationCount;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < cycles; i++)
+        cycle();
+    double ms = msSince(start);
+    size_t allocations = sAllocationCount - allocationsBefore;
+
+    cout << std::fixed << std::setprecision(1) << cycles * transitionsPerCycle << " transitions: "
+         << ms * 1e6 / (cycles * transitionsPerCycle) << " ns/transition (including frames in between), "
+         << allocations << " allocations" << endl;
+}
+
+
+// A crowd of agents running right on a generated level: one Player object each, updated the way
+// World updates its player, vs. AgentStore. Both must end up in the same places.
+static void crowdBenchmark(size_t agentCount)
+{
+    const float dt = 1.0f / 60;
+    const float gravity = 3600;
+    const size_t ticks = 60;
+    const float levelWidth = 100000;
+
+    std::vector<sf::FloatRect> blocks = generateBlocks(10000, levelWidth);
+    blocks.push_back({-1000, 2100, levelWidth + 2000, 400});
+    StaticAabbTree blockTree;
+    blockTree.build(blocks);
+
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> x(0, levelWidth);
+    std::uniform_real_distribution<float> y(-3000, -2200);
+    std::uniform_int_distribution<size_t> block(0, blocks.size() - 2);
+    std::vector<sf::Vector2f> spawns(agentCount);
+    for (size_t i = 0; i < agentCount; i++)
+    {
+        // every tenth agent spawns overlapping a block, so its very first collision rect matters
+        if (i % 10 == 0)
+        {
+            const sf::FloatRect& overlapped = blocks[block(random)];
+            spawns[i] = {overlapped.left + overlapped.width / 2, overlapped.top};
+        }
+        else
+            spawns[i] = {x(random), y(random)};
+    }
+
+    // everybody stands still for the first ticks, then holds Right
+    const size_t standingTicks = 10;
+    InputState input;
+
+    std::vector<std::unique_ptr<Player>> players;
+    for (sf::Vector2f spawn : spawns)
+        players.push_back(std::make_unique<Player>(spawn, false));
+    std::vector<size_t> nearbyIds;
+    std::vector<sf::FloatRect> nearbyBlocks;
+    std::vector<sf::FloatRect> noEnemies;
+    double objects = nsPerFrame(ticks, [&](size_t tick)
+    {
+        input.setKeyPressed(sf::Keyboard::Right, tick >= standingTicks);
+        for (const std::unique_ptr<Player>& player : players)
+        {
+            player->applyVelocity({0, gravity * dt});
+            player->update(dt, input);
+            sf::FloatRect collisionArea = player->getCollisionRect();
+            collisionArea.left -= World::kCollisionMargin;
+            collisionArea.top -= World::kCollisionMargin;
+            collisionArea.width += 2 * World::kCollisionMargin;
+            collisionArea.height += 2 * World::kCollisionMargin;
+            nearbyIds.clear();
+            blockTree.query(collisionArea, nearbyIds);
+            nearbyBlocks.clear();
+            for (size_t id : nearbyIds)
+                nearbyBlocks.push_back(blocks[id]);
+            player->handleAllCollisions(nearbyBlocks, noEnemies);
+        }
+        return players.size();
+    });
+
+    AgentStore agents;
+    agents.reserve(agentCount);
+    for (sf::Vector2f spawn : spawns)
+        agents.add(spawn);
+    double store = nsPerFrame(ticks, [&](size_t tick)
+    {
+        input.setKeyPressed(sf::Keyboard::Right, tick >= standingTicks);
+        agents.update(dt, gravity, input, blockTree, blocks);
+        return agents.size();
+    });
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < agentCount; i++)
+    {
+        if (players[i]->getCenter() != agents.getPosition(i))
+            mismatches++;
+    }
+
+    size_t objectBytes = sizeof(Player) + sizeof(PlayerStates);
+    size_t agentBytes = 2 * sizeof(sf::Vector2f) + sizeof(sf::FloatRect) + sizeof(PlayerStateId) + sizeof(Animation);
+    cout << std::fixed << std::setprecision(3) << std::setw(8) << agentCount << " agents:  objects "
+         << std::setw(8) << objects / 1e6 << " ms/tick (" << objectBytes << " B/agent)  store "
+         << std::setw(7) << store / 1e6 << " ms/tick (" << agentBytes << " B/agent)  "
+         << mismatches << " positions differ" << endl;
+}
+
+
+int main()
+{
+    cout << "Broadphase: one player-sized rect against level blocks" << endl;
+    for (size_t count : {10000, 100000, 1000000})
+        broadphaseBenchmark(count);
+
+    cout << endl << "Attack: sword rect against all enemies" << endl;
+    for (size_t count : {1000, 10000, 100000, 1000000})
+        attackBenchmark(count);
+
+    cout << endl << "Kills: 10% of enemies removed and respawned every frame" << endl;
+    for (size_t count : {10000, 100000})
+        killBenchmark(count);
+
+    cout << endl << "Player state transitions" << endl;
+    transitionBenchmark();
+
+    cout << endl << "Crowds: 60 ticks of agents running across a generated level" << endl;
+    for (size_t count : {10000, 100000})
+        crowdBenchmark(count);
+    return 0;
+}
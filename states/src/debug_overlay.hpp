@@ -0,0 +1,126 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <climits>
+#include <cmath>
+#include <memory>
+#include <string>
+#include "world.hpp"
+#include "resource_cache.hpp"
+
+
+// Debug information drawn over the game and switched with F3: collision shapes,
+// the player's position, frame time and how much of the level the last frame drew.
+// The font comes from the shared cache; texts are rebuilt only when their numbers change.
+class DebugOverlay
+{
+public:
+
+    static constexpr sf::Keyboard::Key kToggleKey = sf::Keyboard::F3;
+
+    explicit DebugOverlay(const std::string& fontPath = "HelveticaRegular.ttf")
+        : mpFont{getResourceCache<sf::Font>().get(fontPath)}
+    {
+        for (sf::Text* text : {&mPositionText, &mFrameText, &mDrawText})
+        {
+            if (mpFont)
+                text->setFont(*mpFont);
+            text->setCharacterSize(20);
+            text->setFillColor(sf::Color::White);
+        }
+        mFrameText.setPosition(10, 10);
+        mDrawText.setPosition(10, 35);
+    }
+
+    void handleEvent(const sf::Event& event)
+    {
+        if (event.type == sf::Event::KeyPressed && event.key.code == kToggleKey)
+            mIsVisible = !mIsVisible;
+    }
+
+    bool isVisible() const
+    {
+        return mIsVisible;
+    }
+
+    void setVisible(bool isVisible)
+    {
+        mIsVisible = isVisible;
+    }
+
+    // Call once per frame with how long the previous frame took
+    void update(double frameTime, const World& world)
+    {
+        if (!mIsVisible)
+            return;
+
+        sf::Vector2f position = world.getPlayerPosition();
+        int x = static_cast<int>(position.x);
+        int y = static_cast<int>(position.y);
+        if (x != mShownX || y != mShownY)
+        {
+            mShownX = x;
+            mShownY = y;
+            mPositionText.setString("x: " + std::to_string(x) + "; y: " + std::to_string(y));
+        }
+        mPositionText.setPosition(position.x - 20, position.y + 10);
+
+        // averaged over a while, a number changing every frame can't be read anyway
+        mFrameTimeSum += frameTime;
+        mFrameCount++;
+        if (mFrameTimeSum >= kFrameTimeWindow)
+        {
+            int frameTenthsMs = static_cast<int>(std::lround(mFrameTimeSum / mFrameCount * 1e4));
+            if (frameTenthsMs != mShownFrameTenthsMs)
+            {
+                mShownFrameTenthsMs = frameTenthsMs;
+                mFrameText.setString("frame: " + std::to_string(frameTenthsMs / 10) + "." + std::to_string(frameTenthsMs % 10) + " ms");
+            }
+            mFrameTimeSum = 0;
+            mFrameCount = 0;
+        }
+
+        const World::DrawStats& stats = world.getDrawStats();
+        if (stats.submittedRects != mShownStats.submittedRects || stats.levelRects != mShownStats.levelRects
+            || stats.drawCalls != mShownStats.drawCalls)
+        {
+            mShownStats = stats;
+            mDrawText.setString("level: " + std::to_string(stats.submittedRects) + " of " + std::to_string(stats.levelRects)
+                + " rects drawn, " + std::to_string(stats.drawCalls) + " draw calls");
+        }
+    }
+
+    // Draws over whatever the world has drawn; leaves the window in its default view
+    void draw(sf::RenderWindow& window, World& world)
+    {
+        if (!mIsVisible)
+            return;
+
+        world.drawDebug(window);
+        if (!mpFont)
+            return;
+        window.draw(mPositionText);
+
+        window.setView(window.getDefaultView());
+        window.draw(mFrameText);
+        window.draw(mDrawText);
+    }
+
+private:
+
+    static constexpr double kFrameTimeWindow = 0.5;
+
+    std::shared_ptr<const sf::Font> mpFont;
+    bool mIsVisible                 {true};
+
+    sf::Text mPositionText          {};
+    sf::Text mFrameText             {};
+    sf::Text mDrawText              {};
+
+    int mShownX                     {INT_MIN};
+    int mShownY                     {INT_MIN};
+    int mShownFrameTenthsMs         {-1};
+    World::DrawStats mShownStats    {static_cast<size_t>(-1), 0, 0};
+    double mFrameTimeSum            {0};
+    int mFrameCount                 {0};
+};
@@ -0,0 +1,131 @@
+// Frame time of drawing a large level: one shape per rect vs. World's culled vertex batches,
+// and of whole frames with the debug overlay off and on.
+// Needs a display; on a server run it under Xvfb with software GL:
+//     make drawbench && xvfb-run -s "-screen 0 1280x1024x24" ./drawbench
+
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "level.hpp"
+#include "debug_overlay.hpp"
+
+using std::cout, std::endl;
+
+
+static double msPerFrame(sf::RenderWindow& window, size_t frames, const std::function<void()>& draw)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < frames; i++)
+    {
+        window.clear(sf::Color::Black);
+        draw();
+        window.display();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+int main()
+{
+    const size_t blockCount = 50000;
+    const size_t enemyCount = 1000;
+    const size_t frames = 100;
+    const float levelWidth = 40000;
+
+    sf::RenderWindow window(sf::VideoMode(1200, 900), "Draw benchmark", sf::Style::Close);
+    window.setVerticalSyncEnabled(false);
+    window.setFramerateLimit(0);
+    // the whole level is on screen, so nothing can be culled
+    sf::View levelView(sf::FloatRect(0, -2000, levelWidth, 4500));
+    sf::View playerView(sf::FloatRect(levelWidth / 2, 0, 1200, 900));
+    window.setView(levelView);
+
+    std::vector<sf::FloatRect> blocks = generateBlocks(blockCount, levelWidth);
+    std::vector<sf::FloatRect> enemies(blocks.end() - enemyCount, blocks.end());
+    blocks.resize(blockCount - enemyCount);
+
+    World world(false);
+    for (const sf::FloatRect& block : blocks)
+        world.addBlock(block);
+    for (const sf::FloatRect& enemy : enemies)
+        world.addEnemy(enemy);
+
+    size_t shapeDrawCalls = 0;
+    sf::RectangleShape shape;
+    double shapes = msPerFrame(window, frames, [&]()
+    {
+        shapeDrawCalls = 0;
+        for (const std::vector<sf::FloatRect>* rects : {&blocks, &enemies})
+        {
+            for (const sf::FloatRect& rect : *rects)
+            {
+                shape.setFillColor(rects == &blocks ? sf::Color(58, 69, 55) : sf::Color(120, 55, 55));
+                shape.setPosition(rect.left, rect.top);
+                shape.setSize({rect.width, rect.height});
+                window.draw(shape);
+                shapeDrawCalls++;
+            }
+        }
+    });
+
+    // the first frame builds the cached block vertices
+    auto firstStart = std::chrono::steady_clock::now();
+    world.drawLevel(window);
+    double firstFrame = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - firstStart).count();
+    double batched = msPerFrame(window, frames, [&]()
+    {
+        world.drawLevel(window);
+    });
+    World::DrawStats levelStats = world.getDrawStats();
+
+    // a normal window-sized view somewhere in the middle of the level
+    window.setView(playerView);
+    double culled = msPerFrame(window, frames, [&]()
+    {
+        world.drawLevel(window);
+    });
+    World::DrawStats playerStats = world.getDrawStats();
+
+    cout << blockCount - enemyCount << " blocks + " << enemyCount << " enemies, " << frames << " frames" << endl;
+    cout << std::fixed << std::setprecision(2)
+         << "  shape per rect:              " << std::setw(8) << shapes << " ms/frame, " << shapeDrawCalls << " draw calls" << endl
+         << "  vertex batches, whole level: " << std::setw(8) << batched << " ms/frame, " << levelStats.drawCalls << " draw calls, "
+         << levelStats.submittedRects << " of " << levelStats.levelRects << " rects submitted"
+         << " (first frame " << firstFrame << " ms, builds the block batch)" << endl
+         << "  vertex batches, 1200x900:    " << std::setw(8) << culled << " ms/frame, " << playerStats.drawCalls << " draw calls, "
+         << playerStats.submittedRects << " of " << playerStats.levelRects << " rects submitted" << endl;
+
+    // whole frames as the game draws them, except the player sprite: World(false) has no texture.
+    // The old overlay loaded its font on every frame
+    DebugOverlay overlay;
+    double overlayTime[2];
+    for (bool isVisible : {false, true})
+    {
+        overlay.setVisible(isVisible);
+        overlayTime[isVisible] = msPerFrame(window, frames, [&]()
+        {
+            overlay.update(1.0 / 60, world);
+            world.draw(window);
+            overlay.draw(window, world);
+        });
+    }
+    double oldOverlay = msPerFrame(window, frames, [&]()
+    {
+        world.draw(window);
+        world.drawDebug(window);
+        sf::Font font;
+        font.loadFromFile("HelveticaRegular.ttf");
+        sf::Text text;
+        text.setFont(font);
+        sf::Vector2f position = world.getPlayerPosition();
+        text.setString("x: " + std::to_string(static_cast<int>(position.x)) + "; y: " + std::to_string(static_cast<int>(position.y)));
+        text.setCharacterSize(20);
+        window.draw(text);
+    });
+    cout << "  frame, overlay off:          " << std::setw(8) << overlayTime[false] << " ms/frame" << endl
+         << "  frame, overlay on:           " << std::setw(8) << overlayTime[true] << " ms/frame" << endl
+         << "  frame, font loaded per frame:" << std::setw(8) << oldOverlay << " ms/frame" << endl;
+    return 0;
+}
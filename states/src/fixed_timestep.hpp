@@ -0,0 +1,41 @@
+#pragma once
+
+
+// Turns real elapsed time into a whole number of simulation ticks of fixed length.
+// Time that doesn't make a full tick is carried over to the next call.
+class FixedTimestep
+{
+public:
+
+    explicit FixedTimestep(double tickTime = 1.0 / 60, int maxTicksPerAdvance = 8)
+        : mTickTime{tickTime}, mMaxTicksPerAdvance{maxTicksPerAdvance}
+    {
+    }
+
+    // Returns how many ticks to simulate for the time that has passed
+    int advance(double elapsed)
+    {
+        mAccumulator += elapsed;
+        int ticks = static_cast<int>(mAccumulator / mTickTime);
+
+        // after a long stall, drop the backlog instead of trying to catch up forever
+        if (ticks > mMaxTicksPerAdvance)
+        {
+            mAccumulator = 0;
+            return mMaxTicksPerAdvance;
+        }
+        mAccumulator -= ticks * mTickTime;
+        return ticks;
+    }
+
+    double getTickTime() const
+    {
+        return mTickTime;
+    }
+
+private:
+
+    double mTickTime;
+    int mMaxTicksPerAdvance;
+    double mAccumulator {0};
+};
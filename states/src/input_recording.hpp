@@ -0,0 +1,254 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "input_source.hpp"
+
+
+// FNV-1a over the exact bits of every player position, one per tick.
+// Two runs with the same hash went through the same trajectory.
+class TrajectoryHash
+{
+public:
+
+    void add(sf::Vector2f position)
+    {
+        addFloat(position.x);
+        addFloat(position.y);
+    }
+
+    std::uint64_t get() const
+    {
+        return mHash;
+    }
+
+private:
+
+    void addFloat(float value)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 4; i++)
+        {
+            mHash ^= (bits >> (8 * i)) & 0xFF;
+            mHash *= 1099511628211ull;
+        }
+    }
+
+    std::uint64_t mHash {14695981039346656037ull};
+};
+
+
+// Trace file layout, fixed-size numbers in the byte order of the machine that wrote them:
+//     header:  "TRC1", tick time (f64)
+//     ticks:   runs of [empty ticks before this one (varint), event count (varint), events]
+//              an event is 2 bytes: sf::Event type, key code + 1 (0 for events without a key)
+//     end:     [trailing empty ticks (varint), 0]
+//     footer:  tick count (u64), trajectory hash (u64)
+// Ticks without events, which is most of them, only cost a counter.
+namespace trace
+{
+    constexpr char kMagic[4] = {'T', 'R', 'C', '1'};
+
+    // A day at 60 Hz. Longer traces are rejected before anything is allocated for them.
+    constexpr std::uint64_t kMaxTicks = 60ull * 60 * 60 * 24;
+
+    inline void writeVarint(std::ostream& out, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.put(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.put(static_cast<char>(value));
+    }
+
+    inline bool readVarint(std::istream& in, std::uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            int byte = in.get();
+            if (byte == std::char_traits<char>::eof())
+                return false;
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    template<class T>
+    void writeRaw(std::ostream& out, T value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template<class T>
+    bool readRaw(std::istream& in, T& value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+}
+
+
+// Writes the input of every tick and the resulting player position to a trace file
+class InputRecorder
+{
+public:
+
+    ~InputRecorder()
+    {
+        close();
+    }
+
+    bool open(const std::string& path, double tickTime)
+    {
+        mFile.open(path, std::ios::binary | std::ios::trunc);
+        if (!mFile)
+            return false;
+        mFile.write(trace::kMagic, sizeof(trace::kMagic));
+        trace::writeRaw(mFile, tickTime);
+        return static_cast<bool>(mFile);
+    }
+
+    // Call once per tick, after the world was updated with frame
+    void record(const InputFrame& frame, sf::Vector2f playerPosition)
+    {
+        mTickCount++;
+        mTrajectory.add(playerPosition);
+        if (frame.events.empty())
+        {
+            mEmptyTicks++;
+            return;
+        }
+
+        trace::writeVarint(mFile, mEmptyTicks);
+        trace::writeVarint(mFile, frame.events.size());
+        for (const sf::Event& event : frame.events)
+        {
+            bool hasKey = event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased;
+            mFile.put(static_cast<char>(event.type));
+            mFile.put(static_cast<char>(hasKey ? event.key.code + 1 : 0));
+        }
+        mEmptyTicks = 0;
+    }
+
+    // Writes the footer; nothing can be recorded afterwards
+    void close()
+    {
+        if (!mFile.is_open())
+            return;
+        trace::writeVarint(mFile, mEmptyTicks);
+        trace::writeVarint(mFile, 0);
+        trace::writeRaw(mFile, mTickCount);
+        trace::writeRaw(mFile, mTrajectory.get());
+        mFile.close();
+    }
+
+private:
+
+    std::ofstream mFile                 {};
+    std::uint64_t mEmptyTicks           {0};
+    std::uint64_t mTickCount            {0};
+    TrajectoryHash mTrajectory          {};
+};
+
+
+// Plays a trace file back, one tick per nextFrame call
+class RecordedInput : public InputSource
+{
+public:
+
+    bool loadFromFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        char magic[sizeof(trace::kMagic)];
+        if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, trace::kMagic, sizeof(magic)) != 0)
+            return false;
+        if (!trace::readRaw(file, mTickTime))
+            return false;
+
+        // The empty tick counts are unchecked varints: read the footer's tick count first
+        // and never let the ticks grow past it
+        std::uint64_t tickCount;
+        std::streampos ticksStart = file.tellg();
+        if (!file.seekg(-static_cast<std::streamoff>(2 * sizeof(std::uint64_t)), std::ios::end) || !trace::readRaw(file, tickCount))
+            return false;
+        if (tickCount > trace::kMaxTicks || !file.seekg(ticksStart))
+            return false;
+
+        mTicks.clear();
+        while (true)
+        {
+            std::uint64_t emptyTicks, eventCount;
+            if (!trace::readVarint(file, emptyTicks) || !trace::readVarint(file, eventCount))
+                return false;
+            if (emptyTicks > tickCount - mTicks.size())
+                return false;
+            mTicks.resize(mTicks.size() + emptyTicks);
+            if (eventCount == 0)
+                break;
+            if (mTicks.size() == tickCount)
+                return false;
+
+            std::vector<sf::Event>& events = mTicks.emplace_back().events;
+            for (std::uint64_t i = 0; i < eventCount; i++)
+            {
+                int type = file.get();
+                int key = file.get();
+                if (key == std::char_traits<char>::eof())
+                    return false;
+                sf::Event event;
+                event.type = static_cast<sf::Event::EventType>(type);
+                event.key = {static_cast<sf::Keyboard::Key>(key - 1), false, false, false, false};
+                events.push_back(event);
+            }
+        }
+
+        std::uint64_t footerTickCount;
+        if (!trace::readRaw(file, footerTickCount) || !trace::readRaw(file, mTrajectoryHash) || footerTickCount != mTicks.size())
+            return false;
+        mNext = 0;
+        return true;
+    }
+
+    void nextFrame(InputFrame& frame) override
+    {
+        frame.events.clear();
+        if (mNext < mTicks.size())
+            frame.events = mTicks[mNext++].events;
+    }
+
+    bool isOver() const
+    {
+        return mNext == mTicks.size();
+    }
+
+    size_t getTickCount() const
+    {
+        return mTicks.size();
+    }
+
+    double getTickTime() const
+    {
+        return mTickTime;
+    }
+
+    // Hash of the player trajectory seen while recording
+    std::uint64_t getTrajectoryHash() const
+    {
+        return mTrajectoryHash;
+    }
+
+private:
+
+    std::vector<InputFrame> mTicks      {};
+    size_t mNext                        {0};
+    double mTickTime                    {1.0 / 60};
+    std::uint64_t mTrajectoryHash       {0};
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <SFML/Window.hpp>
+#include <vector>
+
+
+// Input of one simulation tick: the key events in the order they happened.
+// World replays them into its InputState, so held keys never have to be asked from the OS.
+struct InputFrame
+{
+    std::vector<sf::Event> events {};
+};
+
+
+// Where ticks get their input from: the window, a script or a recording
+class InputSource
+{
+public:
+
+    virtual ~InputSource() = default;
+
+    // Fills frame with the input of the next tick
+    virtual void nextFrame(InputFrame& frame) = 0;
+};
+
+
+// Collects events polled from the window between ticks and hands them to the next tick
+class WindowInput : public InputSource
+{
+public:
+
+    void handleEvent(const sf::Event& event)
+    {
+        if (event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased || event.type == sf::Event::LostFocus)
+            mPending.push_back(event);
+    }
+
+    void nextFrame(InputFrame& frame) override
+    {
+        frame.events.swap(mPending);
+        mPending.clear();
+    }
+
+private:
+
+    std::vector<sf::Event> mPending {};
+};
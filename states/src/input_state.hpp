@@ -0,0 +1,38 @@
+#pragma once
+
+#include <SFML/Window.hpp>
+#include <bitset>
+
+
+// Keys held down, as seen by the game. It is built from key events only,
+// so states never ask the OS and the same input can come from a script.
+class InputState
+{
+public:
+
+    bool isKeyPressed(sf::Keyboard::Key key) const
+    {
+        return key >= 0 && key < sf::Keyboard::KeyCount && mKeys[key];
+    }
+
+    void setKeyPressed(sf::Keyboard::Key key, bool isPressed)
+    {
+        if (key >= 0 && key < sf::Keyboard::KeyCount)
+            mKeys[key] = isPressed;
+    }
+
+    void handleEvent(const sf::Event& event)
+    {
+        if (event.type == sf::Event::KeyPressed)
+            setKeyPressed(event.key.code, true);
+        else if (event.type == sf::Event::KeyReleased)
+            setKeyPressed(event.key.code, false);
+        // releases that happen while the window is out of focus never arrive
+        else if (event.type == sf::Event::LostFocus)
+            mKeys.reset();
+    }
+
+private:
+
+    std::bitset<sf::Keyboard::KeyCount> mKeys {};
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <random>
+#include <vector>
+#include "world.hpp"
+
+
+// The level played in the window, also used by the headless simulation
+inline void buildLevel(World& world)
+{
+    world.addBlock({-500, 770, 20000, 400});
+    world.addBlock({-400, 100, 700, 300});
+    world.addBlock({600, 500, 300, 120});
+    world.addBlock({800, 0, 400, 200});
+    world.addBlock({-100, -700, 400, 100});
+    world.addBlock({700, -700, 400, 100});
+    world.addBlock({1500, -700, 400, 100});
+    world.addBlock({1100, -300, 400, 100});
+
+    world.addBlock({1100, 400, 400, 400});
+
+    world.addBlock({1900, -100, 200, 800});
+
+    world.addBlock({3000, 500, 1000, 200});
+
+    world.addEnemy({1700, 700, 50, 50});
+    world.addEnemy({1330, 320, 50, 50});
+    world.addEnemy({740, 430, 50, 50});
+    world.addEnemy({800, 700, 50, 50});
+    world.addEnemy({2660, 700, 50, 50});
+    world.addEnemy({3200, 430, 50, 50});
+    world.addEnemy({3400, 430, 50, 50});
+    world.addEnemy({3600, 430, 50, 50});
+    world.addEnemy({3800, 430, 50, 50});
+    world.addEnemy({1000, -60, 50, 50});
+    world.addEnemy({1300, -380, 50, 50});
+    world.addEnemy({1700, -780, 50, 50});
+    world.addEnemy({900, -780, 50, 50});
+    world.addEnemy({100, -780, 50, 50});
+    world.addEnemy({-200, -10, 50, 50});
+    world.addEnemy({2000, -180, 50, 50});
+}
+
+
+// Randomly placed flat blocks for benchmarks, the same on every call
+inline std::vector<sf::FloatRect> generateBlocks(size_t count, float levelWidth)
+{
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> x(0, levelWidth);
+    std::uniform_real_distribution<float> y(-2000, 2000);
+    std::uniform_real_distribution<float> size(50, 400);
+
+    std::vector<sf::FloatRect> blocks;
+    blocks.reserve(count);
+    for (size_t i = 0; i < count; i++)
+        blocks.push_back({x(random), y(random), size(random), size(random) / 4});
+    return blocks;
+}
@@ -1,8 +1,50 @@
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
 #include "world.hpp"
+#include "level.hpp"
+#include "fixed_timestep.hpp"
+#include "input_source.hpp"
+#include "input_recording.hpp"
+#include "debug_overlay.hpp"
 
-int main() 
+using std::cout, std::endl;
+
+
+static std::string readOption(int argc, char** argv, const std::string& name)
+{
+    std::string prefix = "--" + name + "=";
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg.compare(0, prefix.size(), prefix) == 0)
+            return arg.substr(prefix.size());
+    }
+    return "";
+}
+
+static bool hasFlag(int argc, char** argv, const std::string& name)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (argv[i] == "--" + name)
+            return true;
+    }
+    return false;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+// Normal game in a window; with recordPath every tick's input goes to a trace file
+static int play(const std::string& recordPath)
 {
     sf::ContextSettings settings;
     settings.antialiasingLevel = 8.0;
@@ -12,39 +54,26 @@ int main()
 
     double time = 0;
     double dt = 1.0 / 60;
+    FixedTimestep timestep {dt};
+    sf::Clock clock;
+    WindowInput input;
+    InputFrame frame;
+
+    InputRecorder recorder;
+    bool isRecording = !recordPath.empty();
+    if (isRecording && !recorder.open(recordPath, dt))
+    {
+        std::cerr << "Can't write trace file " << recordPath << std::endl;
+        return 1;
+    }
 
+    auto startupStart = std::chrono::steady_clock::now();
     World world;
-    world.addBlock({-500, 770, 20000, 400});
-    world.addBlock({-400, 100, 700, 300});
-    world.addBlock({600, 500, 300, 120});
-    world.addBlock({800, 0, 400, 200});
-    world.addBlock({-100, -700, 400, 100});
-    world.addBlock({700, -700, 400, 100});
-    world.addBlock({1500, -700, 400, 100});
-    world.addBlock({1100, -300, 400, 100});
-
-    world.addBlock({1100, 400, 400, 400});
-
-    world.addBlock({1900, -100, 200, 800});
-
-    world.addBlock({3000, 500, 1000, 200});
-
-    world.addEnemy({1700, 700, 50, 50});
-    world.addEnemy({1330, 320, 50, 50});
-    world.addEnemy({740, 430, 50, 50});
-    world.addEnemy({800, 700, 50, 50});
-    world.addEnemy({2660, 700, 50, 50});
-    world.addEnemy({3200, 430, 50, 50});
-    world.addEnemy({3400, 430, 50, 50});
-    world.addEnemy({3600, 430, 50, 50});
-    world.addEnemy({3800, 430, 50, 50});
-    world.addEnemy({1000, -60, 50, 50});
-    world.addEnemy({1300, -380, 50, 50});
-    world.addEnemy({1700, -780, 50, 50});
-    world.addEnemy({900, -780, 50, 50});
-    world.addEnemy({100, -780, 50, 50});
-    world.addEnemy({-200, -10, 50, 50});
-    world.addEnemy({2000, -180, 50, 50});
+    buildLevel(world);
+    DebugOverlay overlay;
+    cout << "Started in " << secondsSince(startupStart) * 1000 << " ms: "
+         << getResourceCache<sf::Texture>().getLoadCount() << " textures and "
+         << getResourceCache<sf::Font>().getLoadCount() << " fonts read from disk" << endl;
 
     while (window.isOpen()) 
     {
@@ -54,19 +83,127 @@ int main()
             if(event.type == sf::Event::Closed) 
                 window.close();
 
-            world.handleEvents(event);
+            input.handleEvent(event);
+            overlay.handleEvent(event);
         }
         window.clear(sf::Color::Black);
-        world.update(dt);
+
+        // the world always moves in steps of dt, however long the frame took
+        double frameTime = clock.restart().asSeconds();
+        int ticks = timestep.advance(frameTime);
+        for (int i = 0; i < ticks; i++)
+        {
+            input.nextFrame(frame);
+            world.update(dt, frame);
+            if (isRecording)
+                recorder.record(frame, world.getPlayerPosition());
+        }
+        overlay.update(frameTime, world);
         world.draw(window);
+        overlay.draw(window, world);
 
         window.display();
 
-        time += dt;
+        time += ticks * dt;
     }
 
     return 0;
 }
 
 
+// Feeds a trace back one tick per frame, as fast as possible, and writes how long
+// every frame took to timingsPath. Fails if the player doesn't take the recorded path.
+static int replay(const std::string& tracePath, const std::string& timingsPath, bool isHeadless, bool withOverlay)
+{
+    RecordedInput input;
+    if (!input.loadFromFile(tracePath))
+    {
+        std::cerr << "Can't read trace file " << tracePath << std::endl;
+        return 1;
+    }
+    std::ofstream timings(timingsPath);
+    if (!timings)
+    {
+        std::cerr << "Can't write " << timingsPath << std::endl;
+        return 1;
+    }
+    timings << "tick,update_us,collision_us,draw_us,submitted_rects,level_rects\n";
+
+    // headless replay loads nothing from disk but the trace, so not even the overlay's font
+    sf::RenderWindow window;
+    std::unique_ptr<DebugOverlay> overlay;
+    if (!isHeadless)
+    {
+        window.create(sf::VideoMode(1200, 900), "Player states (replay)", sf::Style::Close);
+        window.setVerticalSyncEnabled(false);
+        window.setFramerateLimit(0);
+        overlay = std::make_unique<DebugOverlay>();
+        overlay->setVisible(withOverlay);
+    }
+
+    World world(!isHeadless);
+    buildLevel(world);
+    world.setProfiling(true);
+    InputFrame frame;
+    TrajectoryHash trajectory;
+    double lastFrameTime = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t tick = 0; !input.isOver(); tick++)
+    {
+        input.nextFrame(frame);
+        auto updateStart = std::chrono::steady_clock::now();
+        world.update(input.getTickTime(), frame);
+        double update = secondsSince(updateStart);
+        trajectory.add(world.getPlayerPosition());
+
+        double draw = 0;
+        if (!isHeadless)
+        {
+            sf::Event event;
+            while (window.pollEvent(event))
+            {
+            }
+            auto drawStart = std::chrono::steady_clock::now();
+            overlay->update(lastFrameTime, world);
+            window.clear(sf::Color::Black);
+            world.draw(window);
+            overlay->draw(window, world);
+            window.display();
+            draw = secondsSince(drawStart);
+        }
+        lastFrameTime = update + draw;
+
+        double collision = world.getCollisionTime();
+        const World::DrawStats& stats = world.getDrawStats();
+        timings << tick << ',' << (update - collision) * 1e6 << ',' << collision * 1e6 << ',' << draw * 1e6
+                << ',' << stats.submittedRects << ',' << stats.levelRects << '\n';
+    }
+    double seconds = secondsSince(start);
+
+    cout << "Replayed " << input.getTickCount() << " ticks in " << seconds << " s, timings in " << timingsPath << endl;
+    if (trajectory.get() != input.getTrajectoryHash())
+    {
+        std::cerr << "Replay diverged from the recording" << std::endl;
+        return 1;
+    }
+    cout << "Trajectory matches the recording" << endl;
+    return 0;
+}
+
 
+//     ./sfml-app                                   play
+//     ./sfml-app --record=trace.bin                play and record the input
+//     ./sfml-app --replay=trace.bin [--timings=timings.csv] [--headless] [--overlay]
+// F3 switches the debug overlay while playing
+int main(int argc, char** argv) 
+{
+    std::string replayPath = readOption(argc, argv, "replay");
+    if (!replayPath.empty())
+    {
+        std::string timingsPath = readOption(argc, argv, "timings");
+        return replay(replayPath, timingsPath.empty() ? "timings.csv" : timingsPath,
+            hasFlag(argc, argv, "headless"), hasFlag(argc, argv, "overlay"));
+    }
+    return play(readOption(argc, argv, "record"));
+}
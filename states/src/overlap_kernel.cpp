@@ -0,0 +1,134 @@
+#include "overlap_kernel.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define OVERLAP_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+
+namespace
+{
+
+// Every kernel handles rects [begin, end); begin is always a multiple of its batch size
+
+void overlapsScalar(const sf::FloatRect& r, const RectArray& rects, size_t begin, size_t end, std::uint64_t* mask)
+{
+    float right = r.left + r.width;
+    float bottom = r.top + r.height;
+    const float* left = rects.left();
+    const float* top = rects.top();
+    const float* width = rects.width();
+    const float* height = rects.height();
+
+    for (size_t i = begin; i < end; i++)
+    {
+        bool hit = right - left[i] >= 0 && left[i] + width[i] - r.left >= 0
+                && bottom - top[i] >= 0 && top[i] + height[i] - r.top >= 0;
+        mask[i / 64] |= static_cast<std::uint64_t>(hit) << (i % 64);
+    }
+}
+
+#ifdef OVERLAP_KERNEL_X86
+
+size_t overlapsSse2(const sf::FloatRect& r, const RectArray& rects, size_t count, std::uint64_t* mask)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 rectLeft = _mm_set1_ps(r.left);
+    const __m128 rectTop = _mm_set1_ps(r.top);
+    const __m128 rectRight = _mm_set1_ps(r.left + r.width);
+    const __m128 rectBottom = _mm_set1_ps(r.top + r.height);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 left = _mm_loadu_ps(rects.left() + i);
+        __m128 top = _mm_loadu_ps(rects.top() + i);
+        __m128 right = _mm_add_ps(left, _mm_loadu_ps(rects.width() + i));
+        __m128 bottom = _mm_add_ps(top, _mm_loadu_ps(rects.height() + i));
+
+        __m128 hit = _mm_and_ps(
+            _mm_and_ps(_mm_cmpge_ps(_mm_sub_ps(rectRight, left), zero), _mm_cmpge_ps(_mm_sub_ps(right, rectLeft), zero)),
+            _mm_and_ps(_mm_cmpge_ps(_mm_sub_ps(rectBottom, top), zero), _mm_cmpge_ps(_mm_sub_ps(bottom, rectTop), zero)));
+        mask[i / 64] |= static_cast<std::uint64_t>(_mm_movemask_ps(hit)) << (i % 64);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+size_t overlapsAvx2(const sf::FloatRect& r, const RectArray& rects, size_t count, std::uint64_t* mask)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 rectLeft = _mm256_set1_ps(r.left);
+    const __m256 rectTop = _mm256_set1_ps(r.top);
+    const __m256 rectRight = _mm256_set1_ps(r.left + r.width);
+    const __m256 rectBottom = _mm256_set1_ps(r.top + r.height);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 left = _mm256_loadu_ps(rects.left() + i);
+        __m256 top = _mm256_loadu_ps(rects.top() + i);
+        __m256 right = _mm256_add_ps(left, _mm256_loadu_ps(rects.width() + i));
+        __m256 bottom = _mm256_add_ps(top, _mm256_loadu_ps(rects.height() + i));
+
+        __m256 hit = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(_mm256_sub_ps(rectRight, left), zero, _CMP_GE_OQ), _mm256_cmp_ps(_mm256_sub_ps(right, rectLeft), zero, _CMP_GE_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(_mm256_sub_ps(rectBottom, top), zero, _CMP_GE_OQ), _mm256_cmp_ps(_mm256_sub_ps(bottom, rectTop), zero, _CMP_GE_OQ)));
+        mask[i / 64] |= static_cast<std::uint64_t>(_mm256_movemask_ps(hit)) << (i % 64);
+    }
+    return i;
+}
+
+#endif
+
+bool isSupported(OverlapKernel kernel)
+{
+#ifdef OVERLAP_KERNEL_X86
+    if (kernel == OverlapKernel::Avx2)
+        return __builtin_cpu_supports("avx2");
+    if (kernel == OverlapKernel::Sse2)
+        return __builtin_cpu_supports("sse2");
+    return true;
+#else
+    return kernel == OverlapKernel::Scalar;
+#endif
+}
+
+OverlapKernel detectKernel()
+{
+    if (isSupported(OverlapKernel::Avx2))
+        return OverlapKernel::Avx2;
+    if (isSupported(OverlapKernel::Sse2))
+        return OverlapKernel::Sse2;
+    return OverlapKernel::Scalar;
+}
+
+OverlapKernel gKernel = detectKernel();
+
+}
+
+
+void findOverlaps(const sf::FloatRect& rect, const RectArray& rects, std::vector<std::uint64_t>& mask)
+{
+    size_t count = rects.size();
+    mask.assign((count + 63) / 64, 0);
+
+    size_t done = 0;
+#ifdef OVERLAP_KERNEL_X86
+    if (gKernel == OverlapKernel::Avx2)
+        done = overlapsAvx2(rect, rects, count, mask.data());
+    else if (gKernel == OverlapKernel::Sse2)
+        done = overlapsSse2(rect, rects, count, mask.data());
+#endif
+    overlapsScalar(rect, rects, done, count, mask.data());
+}
+
+OverlapKernel getOverlapKernel()
+{
+    return gKernel;
+}
+
+void setOverlapKernel(OverlapKernel kernel)
+{
+    gKernel = isSupported(kernel) ? kernel : OverlapKernel::Scalar;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "rect_array.hpp"
+
+
+// Batch version of Player::handleAttackCollision: tests one rect against many.
+// Bit i % 64 of mask[i / 64] is set when rects[i] overlaps rect (touching counts).
+// Uses the same arithmetic as the scalar test, so both always agree.
+//
+// The implementation is picked once at startup from what the CPU supports:
+// AVX2 (8 rects per instruction), SSE2 (4 rects) or plain scalar code.
+void findOverlaps(const sf::FloatRect& rect, const RectArray& rects, std::vector<std::uint64_t>& mask);
+
+enum class OverlapKernel {Scalar, Sse2, Avx2};
+
+OverlapKernel getOverlapKernel();
+
+// Forces a kernel, e.g. to compare them; falls back to scalar if the CPU can't run it
+void setOverlapKernel(OverlapKernel kernel);
@@ -4,32 +4,39 @@
 #include <cmath>
 #include "player.hpp"
 #include "player_states.hpp"
+#include "resource_cache.hpp"
 
 
 
-Player::Player(sf::Vector2f position) : mPosition{position}
+Player::Player(sf::Vector2f position, bool loadTexture) : mPosition{position}
 {
-    if (!mTexture.loadFromFile("./hero.png"))
+    // every player draws from the same texture
+    if (loadTexture)
     {
-        std::cerr << "Can't load image ./hero.png for Player class" << std::endl;
-        std::exit(1);
+        mpTexture = getResourceCache<sf::Texture>().get("./hero.png");
+        if (!mpTexture)
+        {
+            std::cerr << "Can't load image ./hero.png for Player class" << std::endl;
+            std::exit(1);
+        }
+        mSprite.setTexture(*mpTexture);
     }
 
-    setState(new Idle(this));
+    mpStates = new PlayerStates();
+    setState(mpStates->get<Idle>());
 
-    mSprite.setTexture(mTexture);
     mSprite.setOrigin(mSprite.getLocalBounds().width / 2, mSprite.getLocalBounds().height / 2);
     mSprite.setPosition(mPosition);
 
     
-    mScaleFactor = 4;
+    mScaleFactor = kScaleFactor;
     mSprite.setScale(mScaleFactor, mScaleFactor);
 }
 
-void Player::setState(PlayerState* pNewState)
+void Player::setState(PlayerState& newState)
 {
-    delete mpState;
-    mpState = pNewState;
+    newState.enter(this);
+    mpState = &newState;
 }
 
 
@@ -38,15 +45,25 @@ sf::Vector2f Player::getCenter() const
     return mPosition;
 }
 
+sf::FloatRect Player::getCollisionRect() const
+{
+    return {mPosition.x + mCollisionRect.left, mPosition.y + mCollisionRect.top, mCollisionRect.width, mCollisionRect.height};
+}
+
+sf::FloatRect Player::getSwordCollisionRect() const
+{
+    return {mPosition.x + mSwordCollisionRect.left, mPosition.y + mSwordCollisionRect.top, mSwordCollisionRect.width, mSwordCollisionRect.height};
+}
+
 
 void Player::applyVelocity(sf::Vector2f velocity)
 {
     mVelocity += velocity;
 }
 
-void Player::update(float dt)
+void Player::update(float dt, const InputState& input)
 {
-    mpState->update(this, dt);
+    mpState->update(this, dt, input);
     mPosition += mVelocity * dt;
 
     mSprite.setOrigin(mSprite.getLocalBounds().width / 2, mSprite.getLocalBounds().height / 2);
@@ -57,46 +74,36 @@ void Player::update(float dt)
 void Player::draw(sf::RenderWindow& window)
 {
     window.draw(mSprite);
+}
 
-    if (true) // For debuging
-    {
-        sf::RectangleShape shape {{mCollisionRect.width, mCollisionRect.height}};
-        shape.setPosition(mPosition.x + mCollisionRect.left, mPosition.y + mCollisionRect.top);
-        shape.setFillColor(sf::Color(150, 50, 50, 50));
-        window.draw(shape);
-
-        sf::RectangleShape swordShape {{mSwordCollisionRect.width, mSwordCollisionRect.height}};
-        swordShape.setPosition(mPosition.x + mSwordCollisionRect.left, mPosition.y + mSwordCollisionRect.top);
-        swordShape.setFillColor(sf::Color(50, 150, 50, 50));
-        window.draw(swordShape);
-
-        sf::Font font;
-        font.loadFromFile("HelveticaRegular.ttf");
-        sf::Text text;
-        text.setFont(font);
-        text.setString("x: " + std::to_string(static_cast<int>(mPosition.x)) + "; y: " + std::to_string(static_cast<int>(mPosition.y)));
-        text.setCharacterSize(20);
-        text.setFillColor(sf::Color::White);
-        text.setPosition({mPosition.x - 20, mPosition.y + 10});
-        window.draw(text);
-
-        sf::CircleShape center {6};
-        center.setFillColor(sf::Color::Red);
-        center.setOrigin(center.getRadius(), center.getRadius());
-        center.setPosition(mPosition);
-        window.draw(center);
-    }
+void Player::drawDebug(sf::RenderWindow& window)
+{
+    sf::RectangleShape shape {{mCollisionRect.width, mCollisionRect.height}};
+    shape.setPosition(mPosition.x + mCollisionRect.left, mPosition.y + mCollisionRect.top);
+    shape.setFillColor(sf::Color(150, 50, 50, 50));
+    window.draw(shape);
+
+    sf::RectangleShape swordShape {{mSwordCollisionRect.width, mSwordCollisionRect.height}};
+    swordShape.setPosition(mPosition.x + mSwordCollisionRect.left, mPosition.y + mSwordCollisionRect.top);
+    swordShape.setFillColor(sf::Color(50, 150, 50, 50));
+    window.draw(swordShape);
+
+    sf::CircleShape center {6};
+    center.setFillColor(sf::Color::Red);
+    center.setOrigin(center.getRadius(), center.getRadius());
+    center.setPosition(mPosition);
+    window.draw(center);
 }
 
 
-void Player::handleEvents(const sf::Event& event) 
+void Player::handleEvents(const sf::Event& event, const InputState& input) 
 {
-    mpState->handleEvents(this, event);
+    mpState->handleEvents(this, event, input);
 }
 
 bool Player::handleCollision(const sf::FloatRect& rect)
 {
-    sf::FloatRect playerRect = {mPosition.x + mCollisionRect.left, mPosition.y + mCollisionRect.top, mCollisionRect.width, mCollisionRect.height};
+    sf::FloatRect playerRect = getCollisionRect();
 
     float overlapx1 = playerRect.left + playerRect.width - rect.left;
     float overlapx2 = rect.left + rect.width - playerRect.left;
@@ -168,7 +175,7 @@ void Player::handleAllCollisions(const std::vector<sf::FloatRect>& blocks, const
 
 bool Player::handleAttackCollision(const sf::FloatRect& enemy)
 {
-    sf::FloatRect swordRect = {mPosition.x + mSwordCollisionRect.left, mPosition.y + mSwordCollisionRect.top, mSwordCollisionRect.width, mSwordCollisionRect.height};
+    sf::FloatRect swordRect = getSwordCollisionRect();
     float overlapx1 = swordRect.left + swordRect.width - enemy.left;
     float overlapx2 = enemy.left + enemy.width - swordRect.left;
     float overlapy1 = swordRect.top + swordRect.height - enemy.top;
@@ -179,5 +186,5 @@ bool Player::handleAttackCollision(const sf::FloatRect& enemy)
 
 Player::~Player()
 {
-    delete mpState;
+    delete mpStates;
 }
\ No newline at end of file
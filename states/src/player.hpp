@@ -2,22 +2,36 @@
 
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
+#include <memory>
+#include "input_state.hpp"
 #include "player_states.hpp"
 
 class PlayerState;
+class PlayerStates;
 
 class Player
 {
 public:
 
-    Player(sf::Vector2f position);
+    // Without the texture the player can be simulated on a machine without a display
+    Player(sf::Vector2f position, bool loadTexture = true);
+    Player(const Player&) = delete;
+    Player& operator=(const Player&) = delete;
+
+    // Sprite and collision rects are scaled by this. The first state is entered before
+    // it is set, so until the first transition the collision rect is unscaled.
+    static constexpr float kScaleFactor = 4;
 
     sf::Vector2f getCenter() const;
+    sf::FloatRect getCollisionRect() const;
+    sf::FloatRect getSwordCollisionRect() const;
     void applyVelocity(sf::Vector2f velocity);
 
-    void update(float dt);
+    void update(float dt, const InputState& input);
     void draw(sf::RenderWindow& window);
-    void handleEvents(const sf::Event& event);
+    // Collision rects and the center, drawn by the debug overlay
+    void drawDebug(sf::RenderWindow& window);
+    void handleEvents(const sf::Event& event, const InputState& input);
     bool handleCollision(const sf::FloatRect& rect);
     void handleAllCollisions(const std::vector<sf::FloatRect>& blocks, const std::vector<sf::FloatRect>& enemies);
     bool handleAttackCollision(const sf::FloatRect& enemy);
@@ -45,12 +59,13 @@ private:
     sf::FloatRect   mCollisionRect      {-40, -60, 80, 120};
     sf::FloatRect   mSwordCollisionRect {0, 0, 0, 0};
 
+    PlayerStates*   mpStates            {nullptr};
     PlayerState*    mpState             {nullptr};
-    sf::Texture     mTexture            {};
+    std::shared_ptr<const sf::Texture> mpTexture {};
     sf::Sprite      mSprite             {}; 
     float           mScaleFactor        {1};
     bool            mIsFacedRight       {true};
     
     
-    void setState(PlayerState* pNewState);
+    void setState(PlayerState& newState);
 };
\ No newline at end of file
@@ -36,6 +36,18 @@ void PlayerState::jump(Player* player)
     startFalling(player);
 }
 
+template<class State>
+void PlayerState::setState(Player* player)
+{
+    player->setState(player->mpStates->get<State>());
+}
+
+void PlayerState::log(const char* stateName) const
+{
+    if (sIsLoggingEnabled)
+        cout << "Entering " << stateName << " state" << endl;
+}
+
 PlayerState::~PlayerState() 
 {
 }
@@ -49,19 +61,125 @@ sf::FloatRect operator*(float x, sf::FloatRect rect)
 
 
 
-Idle::Idle(Player* player) 
+// Animation clips, one per state. Frames are texture rects in hero.png
+
+constexpr AnimationFrame kIdleFrames[] =
+{
+    { 14, 6, 21, 30},
+    { 64, 6, 21, 30},
+    {114, 6, 21, 30},
+    {164, 6, 21, 30},
+};
+constexpr AnimationClip kIdleClip = makeAnimationClip(kIdleFrames, 6);
+
+constexpr AnimationFrame kRunningFrames[] =
+{
+    { 67, 45, 20, 27},
+    {116, 46, 20, 27},
+    {166, 48, 20, 27},
+    {217, 45, 20, 27},
+    {266, 46, 20, 27},
+    {316, 48, 20, 27},
+};
+constexpr AnimationClip kRunningClip = makeAnimationClip(kRunningFrames, 12);
+
+constexpr AnimationFrame kSlidingFrames[] =
+{
+    {155, 119, 34, 28},
+    {205, 119, 34, 28},
+    {255, 119, 34, 28},
+    {307, 119, 34, 28},
+    {  9, 156, 34, 28},
+};
+constexpr AnimationClip kSlidingClip = makeAnimationClip(kSlidingFrames, 10, AnimationType::OneIteration);
+
+constexpr AnimationFrame kFallingFrames[] =
+{
+    {321, 155, 15, 26},
+};
+constexpr AnimationClip kFallingClip = makeAnimationClip(kFallingFrames, 12);
+
+constexpr AnimationFrame kHookedFrames[] =
+{
+    { 70, 151, 16, 34},
+    {119, 151, 16, 34},
+    {169, 151, 16, 34},
+    {219, 151, 16, 34},
+};
+constexpr AnimationClip kHookedClip = makeAnimationClip(kHookedFrames, 12, AnimationType::OneIteration);
+
+constexpr AnimationFrame kSittingFrames[] =
+{
+    { 65, 340, 19, 29},
+    {116, 340, 22, 29},
+    {168, 340, 20, 29},
+    {221, 340, 15, 29},
+};
+constexpr AnimationClip kSittingClip = makeAnimationClip(kSittingFrames, 25, AnimationType::OneIteration);
+
+constexpr AnimationFrame kFirstAttackFrames[] =
+{
+    {58, 238, 25, 20},
+    {115, 222, 34, 36},
+    {215, 226, 20, 32},
+    {265, 232, 18, 26},
+};
+constexpr AnimationClip kFirstAttackClip = makeAnimationClip(kFirstAttackFrames, 12, AnimationType::OneIteration);
+
+constexpr AnimationFrame kSecondAttackFrames[] =
+{
+    {13, 268, 20, 27},
+    {60, 266, 37, 29},
+    {102, 274, 32, 21},
+    {152, 273, 31, 22},
+};
+constexpr AnimationClip kSecondAttackClip = makeAnimationClip(kSecondAttackFrames, 12, AnimationType::OneIteration);
+
+constexpr AnimationFrame kThirdAttackFrames[] =
+{
+    {152, 273, 31, 22},
+    {219, 269, 20, 26},
+    {270, 269, 20, 26},
+    {302, 272, 48, 23},
+    {3, 313, 31, 19},
+    {50, 312, 34, 20},
+    {100, 312, 34, 20},
+};
+constexpr AnimationClip kThirdAttackClip = makeAnimationClip(kThirdAttackFrames, 14, AnimationType::OneIteration);
+
+const AnimationClip& getAnimationClip(PlayerStateId state)
+{
+    switch (state)
+    {
+        case PlayerStateId::Idle:           return kIdleClip;
+        case PlayerStateId::Running:        return kRunningClip;
+        case PlayerStateId::Sliding:        return kSlidingClip;
+        case PlayerStateId::Falling:        return kFallingClip;
+        case PlayerStateId::Hooked:         return kHookedClip;
+        case PlayerStateId::Sitting:        return kSittingClip;
+        case PlayerStateId::FirstAttack:    return kFirstAttackClip;
+        case PlayerStateId::SecondAttack:   return kSecondAttackClip;
+        case PlayerStateId::ThirdAttack:    return kThirdAttackClip;
+    }
+    return kIdleClip;
+}
+
+
+
+Idle::Idle()
+{
+    mAnimation = Animation(kIdleClip);
+}
+
+void Idle::enter(Player* player)
 {
+    mAnimation.reset();
+
     player->mVelocity = {0, 0};
-    mAnimation = Animation();
-    mAnimation.setAnimationSpeed(6);
-    mAnimation.addTextureRect({ 14, 6, 21, 30});
-    mAnimation.addTextureRect({ 64, 6, 21, 30});
-    mAnimation.addTextureRect({114, 6, 21, 30});
-    mAnimation.addTextureRect({164, 6, 21, 30});
 
-    player->mCollisionRect =  player->mScaleFactor * sf::FloatRect(-10, -15, 20, 30);
+    player->mCollisionRect =  player->mScaleFactor * kUprightRect;
 
-    cout << "Creating Idle state" << endl;
+    log("Idle");
 }
 
 
@@ -69,30 +187,30 @@ void Idle::hook(Player* player)
 {  
 }
 
-void Idle::update(Player* player, float dt)
+void Idle::update(Player* player, float dt, const InputState& input)
 {
     mAnimation.update(dt);
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) || sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+    if (input.isKeyPressed(sf::Keyboard::Left) || input.isKeyPressed(sf::Keyboard::Right))
     {
-        player->setState(new Running(player));
+        setState<Running>(player);
     }
-    else if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift))
+    else if (input.isKeyPressed(sf::Keyboard::LShift))
     {
-        player->setState(new Sitting(player));
+        setState<Sitting>(player);
     }
-    else if (sf::Keyboard::isKeyPressed(sf::Keyboard::X))
+    else if (input.isKeyPressed(sf::Keyboard::X))
     {
-        player->setState(new FirstAttack(player));
+        setState<FirstAttack>(player);
     }
 }
 
-void Idle::handleEvents(Player* player, const sf::Event& event) 
+void Idle::handleEvents(Player* player, const sf::Event& event, const InputState& input) 
 {
     if (event.type == sf::Event::KeyPressed)
     {
         if (event.key.code == sf::Keyboard::Left || event.key.code == sf::Keyboard::Right)
         {
-            player->setState(new Running(player));
+            setState<Running>(player);
         }
 
         else if (event.key.code == sf::Keyboard::Space)
@@ -102,19 +220,19 @@ void Idle::handleEvents(Player* player, const sf::Event& event)
 
         else if (event.key.code == sf::Keyboard::LShift)
         {
-            player->setState(new Sitting(player));
+            setState<Sitting>(player);
         }
 
         else if (event.key.code == sf::Keyboard::X)
         {
-            player->setState(new FirstAttack(player));
+            setState<FirstAttack>(player);
         }
     }
 }
 
 void Idle::startFalling(Player* player)
 {
-    player->setState(new Falling(player));
+    setState<Falling>(player);
 }
 
 void Idle::hitGround(Player* player)
@@ -129,21 +247,18 @@ void Idle::hitGround(Player* player)
 
 
 
-Running::Running(Player* player) : PlayerState()
+Running::Running() : PlayerState()
 {
-    mRunningSpeed = 900;
-    mAnimation = Animation();
-    mAnimation.setAnimationSpeed(12);
-    mAnimation.addTextureRect({ 67, 45, 20, 27});
-    mAnimation.addTextureRect({116, 46, 20, 27});
-    mAnimation.addTextureRect({166, 48, 20, 27});
-    mAnimation.addTextureRect({217, 45, 20, 27});
-    mAnimation.addTextureRect({266, 46, 20, 27});
-    mAnimation.addTextureRect({316, 48, 20, 27});
+    mAnimation = Animation(kRunningClip);
+}
 
-    player->mCollisionRect = player->mScaleFactor * sf::FloatRect(-10, -15, 20, 30);;
+void Running::enter(Player* player)
+{
+    mAnimation.reset();
 
-    cout << "Creating Running state" << endl;
+    player->mCollisionRect = player->mScaleFactor * kUprightRect;;
+
+    log("Running");
 }
 
 void Running::hook(Player* player)
@@ -151,26 +266,26 @@ void Running::hook(Player* player)
 }
 
 
-void Running::update(Player* player, float dt)
+void Running::update(Player* player, float dt, const InputState& input)
 {
     mAnimation.update(dt);
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
+    if (input.isKeyPressed(sf::Keyboard::Left))
     {
-        player->mVelocity.x = -mRunningSpeed;
+        player->mVelocity.x = -kRunningSpeed;
         player->mIsFacedRight = false;
     }
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+    if (input.isKeyPressed(sf::Keyboard::Right))
     {
-        player->mVelocity.x = mRunningSpeed;
+        player->mVelocity.x = kRunningSpeed;
         player->mIsFacedRight = true;
     }
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::X))
+    if (input.isKeyPressed(sf::Keyboard::X))
     {
-        player->setState(new FirstAttack(player));
+        setState<FirstAttack>(player);
     }
 }
 
-void Running::handleEvents(Player* player, const sf::Event& event)
+void Running::handleEvents(Player* player, const sf::Event& event, const InputState& input)
 {
     if (event.type == sf::Event::KeyPressed)
     {
@@ -182,26 +297,26 @@ void Running::handleEvents(Player* player, const sf::Event& event)
 
         else if (event.key.code == sf::Keyboard::LShift)
         {
-            player->setState(new Sliding(player));
+            setState<Sliding>(player);
         }
 
         else if (event.key.code == sf::Keyboard::X)
         {
-            player->setState(new FirstAttack(player));
+            setState<FirstAttack>(player);
         }
 
     }
     else if (event.type == sf::Event::KeyReleased)
     {
-        if (event.key.code == sf::Keyboard::Left && !sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+        if (event.key.code == sf::Keyboard::Left && !input.isKeyPressed(sf::Keyboard::Right))
         {
-            player->setState(new Idle(player));
+            setState<Idle>(player);
             player->mVelocity.x = 0;
         }
 
-        else if (event.key.code == sf::Keyboard::Right && !sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
+        else if (event.key.code == sf::Keyboard::Right && !input.isKeyPressed(sf::Keyboard::Left))
         {
-            player->setState(new Idle(player));
+            setState<Idle>(player);
             player->mVelocity.x = 0;
         }
     }
@@ -209,7 +324,7 @@ void Running::handleEvents(Player* player, const sf::Event& event)
 
 void Running::startFalling(Player* player)
 {
-    player->setState(new Falling(player));
+    setState<Falling>(player);
 }
 
 void Running::hitGround(Player* player)
@@ -222,26 +337,25 @@ void Running::hitGround(Player* player)
 
 
 
-Sliding::Sliding(Player* player) : PlayerState()
+Sliding::Sliding() : PlayerState()
+{
+    mAnimation = Animation(kSlidingClip);
+}
+
+void Sliding::enter(Player* player)
 {
+    mAnimation.reset();
+
     if (player->mVelocity.x > 0)
         player->mVelocity.x = kSlidingVelocity;
     else if (player->mVelocity.x < 0)
         player->mVelocity.x = -kSlidingVelocity;
 
-    mAnimation = Animation(Animation::AnimationType::OneIteration);
-    mAnimation.setAnimationSpeed(10);
-    mAnimation.addTextureRect({155, 119, 34, 28});
-    mAnimation.addTextureRect({205, 119, 34, 28});
-    mAnimation.addTextureRect({255, 119, 34, 28});
-    mAnimation.addTextureRect({307, 119, 34, 28});
-    mAnimation.addTextureRect({  9, 156, 34, 28});
-
     player->mCollisionRect = sf::FloatRect(-80, -20, 160, 80);
     player->mCollisionRect = player->mScaleFactor * sf::FloatRect(-20, -5, 40, 20);
     mCurrentTime = kSlidingTime;
 
-    cout << "Creating Sliding state" << endl;    
+    log("Sliding");
 }
 
 void Sliding::hook(Player* player)
@@ -249,28 +363,28 @@ void Sliding::hook(Player* player)
 }
 
 
-void Sliding::update(Player* player, float dt)
+void Sliding::update(Player* player, float dt, const InputState& input)
 {
     mAnimation.update(dt);
     player->mVelocity.x *= kVelocityDecay;
     mCurrentTime -= dt;
     if (mCurrentTime < 0 && player->mIsColliding)
     {
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) || sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
-            player->setState(new Running(player));
+        if (input.isKeyPressed(sf::Keyboard::Left) || input.isKeyPressed(sf::Keyboard::Right))
+            setState<Running>(player);
         else
-            player->setState(new Idle(player));
+            setState<Idle>(player);
         return;
     }
 }
-void Sliding::handleEvents(Player* player, const sf::Event& event)
+void Sliding::handleEvents(Player* player, const sf::Event& event, const InputState& input)
 {
     if (event.type == sf::Event::KeyPressed)
     {
         if (event.key.code == sf::Keyboard::Space && player->mIsColliding)
         {
             jump(player);
-            player->setState(new Falling(player));
+            setState<Falling>(player);
         }
     }
 }
@@ -290,46 +404,50 @@ void Sliding::hitGround(Player* player)
 
 
 
-Falling::Falling(Player* player) : PlayerState()
+Falling::Falling() : PlayerState()
+{
+    mAnimation = Animation(kFallingClip);
+}
+
+void Falling::enter(Player* player)
 {
-    mAnimation = Animation();
-    mAnimation.setAnimationSpeed(12);
-    mAnimation.addTextureRect({321, 155, 15, 26});
+    mAnimation.reset();
 
-    player->mCollisionRect = player->mScaleFactor * sf::FloatRect(-10, -15, 20, 30);;
+    player->mCollisionRect = player->mScaleFactor * kUprightRect;;
 
     mHasJumped = false;
+    mSpacePressedFrames = 0;
 
-    cout << "Creating Falling state" << endl;
+    log("Falling");
 }
 
 void Falling::hook(Player* player)
 {
-    player->setState(new Hooked(player));
+    setState<Hooked>(player);
 }
 
 
-void Falling::update(Player* player, float dt)
+void Falling::update(Player* player, float dt, const InputState& input)
 {
     mAnimation.update(dt);
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
+    if (input.isKeyPressed(sf::Keyboard::Left))
     {
         player->mVelocity.x = -kHorizontalVelocity;
         player->mIsFacedRight = false;
     }
 
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+    if (input.isKeyPressed(sf::Keyboard::Right))
     {
         player->mVelocity.x = kHorizontalVelocity;
         player->mIsFacedRight = true;
     }
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space) && mSpacePressedFrames < 100)
+    if (input.isKeyPressed(sf::Keyboard::Space) && mSpacePressedFrames < 100)
         mSpacePressedFrames += 1;
     else
         mSpacePressedFrames = 0;
 }
 
-void Falling::handleEvents(Player* player, const sf::Event& event)
+void Falling::handleEvents(Player* player, const sf::Event& event, const InputState& input)
 {
     if (event.type == sf::Event::KeyPressed
         && event.key.code == sf::Keyboard::Space
@@ -350,7 +468,7 @@ void Falling::startFalling(Player* player)
 
 void Falling::hitGround(Player* player)
 {
-    player->setState(new Idle(player));
+    setState<Idle>(player);
 }
 
 
@@ -359,18 +477,18 @@ void Falling::hitGround(Player* player)
 
 
 
-Hooked::Hooked(Player* player) : PlayerState()
+Hooked::Hooked() : PlayerState()
+{
+    mAnimation = Animation(kHookedClip);
+}
+
+void Hooked::enter(Player* player)
 {
-    mAnimation = Animation(Animation::AnimationType::OneIteration);
-    mAnimation.setAnimationSpeed(12);
-    mAnimation.addTextureRect({ 70, 151, 16, 34});
-    mAnimation.addTextureRect({119, 151, 16, 34});
-    mAnimation.addTextureRect({169, 151, 16, 34});
-    mAnimation.addTextureRect({219, 151, 16, 34});
+    mAnimation.reset();
 
-    player->mCollisionRect = player->mScaleFactor * sf::FloatRect(-10, -15, 20, 30);;
+    player->mCollisionRect = player->mScaleFactor * kUprightRect;;
 
-    cout << "Creating Hooked state" << endl;
+    log("Hooked");
 }
 
 void Hooked::hook(Player* player)
@@ -378,13 +496,13 @@ void Hooked::hook(Player* player)
 }
 
 
-void Hooked::update(Player* player, float dt)
+void Hooked::update(Player* player, float dt, const InputState& input)
 {
     player->mVelocity = {0, 0};
     mAnimation.update(dt);
 }
 
-void Hooked::handleEvents(Player* player, const sf::Event& event)
+void Hooked::handleEvents(Player* player, const sf::Event& event, const InputState& input)
 {
     if (event.type == sf::Event::KeyPressed)
     {
@@ -394,35 +512,36 @@ void Hooked::handleEvents(Player* player, const sf::Event& event)
         else if (event.key.code == sf::Keyboard::Down)
         {
             player->mVelocity.x = player->mIsFacedRight ? -100 : 100;
-            player->setState(new Falling(player));
+            setState<Falling>(player);
         }
     }
 }
 
 void Hooked::startFalling(Player* player)
 {
-    player->setState(new Falling(player));
+    setState<Falling>(player);
 }
 
 void Hooked::hitGround(Player* player)
 {
-    player->setState(new Idle(player));
+    setState<Idle>(player);
 }
 
 
-Sitting::Sitting(Player* player) 
+Sitting::Sitting()
 {
+    mAnimation = Animation(kSittingClip);
+}
+
+void Sitting::enter(Player* player)
+{
+    mAnimation.reset();
+
     player->mVelocity = {0, 0};
-    mAnimation = Animation(Animation::AnimationType::OneIteration);
-    mAnimation.setAnimationSpeed(25);
-    mAnimation.addTextureRect({ 65, 340, 19, 29});
-    mAnimation.addTextureRect({116, 340, 22, 29});
-    mAnimation.addTextureRect({168, 340, 20, 29});
-    mAnimation.addTextureRect({221, 340, 15, 29});
 
     player->mCollisionRect = player->mScaleFactor * sf::FloatRect(-10, 0, 20, 15);
-    
-    cout << "Creating Sitting state" << endl;
+
+    log("Sitting");
 }
 
 
@@ -430,22 +549,22 @@ void Sitting::hook(Player* player)
 {  
 }
 
-void Sitting::update(Player* player, float dt)
+void Sitting::update(Player* player, float dt, const InputState& input)
 {
     mAnimation.update(dt);
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) || sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+    if (input.isKeyPressed(sf::Keyboard::Left) || input.isKeyPressed(sf::Keyboard::Right))
     {
-        player->setState(new Running(player));
+        setState<Running>(player);
     }
 }
 
-void Sitting::handleEvents(Player* player, const sf::Event& event) 
+void Sitting::handleEvents(Player* player, const sf::Event& event, const InputState& input) 
 {
     if (event.type == sf::Event::KeyPressed)
     {
         if (event.key.code == sf::Keyboard::Left || event.key.code == sf::Keyboard::Right)
         {
-            player->setState(new Running(player));
+            setState<Running>(player);
         }
 
         else if (event.key.code == sf::Keyboard::Space)
@@ -457,14 +576,14 @@ void Sitting::handleEvents(Player* player, const sf::Event& event)
     {
         if (event.key.code == sf::Keyboard::LShift)
         {
-            player->setState(new Idle(player));
+            setState<Idle>(player);
         }
     }
 }
 
 void Sitting::startFalling(Player* player)
 {
-    player->setState(new Falling(player));
+    setState<Falling>(player);
 }
 
 void Sitting::hitGround(Player* player)
@@ -472,23 +591,24 @@ void Sitting::hitGround(Player* player)
 }
 
 
-FirstAttack::FirstAttack(Player* player) 
+FirstAttack::FirstAttack()
+{
+    mAnimation = Animation(kFirstAttackClip);
+}
+
+void FirstAttack::enter(Player* player)
 {
-    mAnimation = Animation(Animation::AnimationType::OneIteration);
-    mAnimation.setAnimationSpeed(12);
-    mAnimation.addTextureRect({58, 238, 25, 20});
-    mAnimation.addTextureRect({115, 222, 34, 36});
-    mAnimation.addTextureRect({215, 226, 20, 32});
-    mAnimation.addTextureRect({265, 232, 18, 26});
+    mAnimation.reset();
 
-    player->mCollisionRect =  player->mScaleFactor * sf::FloatRect(-10, -15, 20, 30);
+    player->mCollisionRect =  player->mScaleFactor * kUprightRect;
     if (player->mIsFacedRight)
         player->mSwordCollisionRect = player->mScaleFactor * sf::FloatRect(-15, -20, 38, 35);
     else
         player->mSwordCollisionRect = player->mScaleFactor * sf::FloatRect(-23, -20, 38, 35);
     mCurrentTime = kAttackTime;
-    
-    cout << "Creating First Attack state" << endl;
+    secondAttackTriggered = false;
+
+    log("First Attack");
 }
 
 
@@ -496,7 +616,7 @@ void FirstAttack::hook(Player* player)
 {  
 }
 
-void FirstAttack::update(Player* player, float dt)
+void FirstAttack::update(Player* player, float dt, const InputState& input)
 {
     mAnimation.update(dt);
     player->mVelocity.x *= kVelocityDecay;
@@ -504,29 +624,29 @@ void FirstAttack::update(Player* player, float dt)
     if (mCurrentTime < 0 && player->mIsColliding)
     {
         if (secondAttackTriggered)
-            player->setState(new SecondAttack(player));
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) || sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+            setState<SecondAttack>(player);
+        else if (input.isKeyPressed(sf::Keyboard::Left) || input.isKeyPressed(sf::Keyboard::Right))
         {
-            player->setState(new Running(player));
+            setState<Running>(player);
             player->mSwordCollisionRect = sf::FloatRect(0, 0, 0, 0);
         }
         else
         {
-            player->setState(new Idle(player));
+            setState<Idle>(player);
             player->mSwordCollisionRect = sf::FloatRect(0, 0, 0, 0);
         }
         return;
     }
 }
 
-void FirstAttack::handleEvents(Player* player, const sf::Event& event) 
+void FirstAttack::handleEvents(Player* player, const sf::Event& event, const InputState& input) 
 {
     if (event.type == sf::Event::KeyPressed)
     {
         if (event.key.code == sf::Keyboard::Space && player->mIsColliding)
         {
             jump(player);
-            player->setState(new Falling(player));
+            setState<Falling>(player);
             player->mSwordCollisionRect = sf::FloatRect(0, 0, 0, 0);
         }
         else if (event.key.code == sf::Keyboard::X) {
@@ -545,23 +665,24 @@ void FirstAttack::hitGround(Player* player)
 }
 
 
-SecondAttack::SecondAttack(Player* player) 
+SecondAttack::SecondAttack()
+{
+    mAnimation = Animation(kSecondAttackClip);
+}
+
+void SecondAttack::enter(Player* player)
 {
-    mAnimation = Animation(Animation::AnimationType::OneIteration);
-    mAnimation.setAnimationSpeed(12);
-    mAnimation.addTextureRect({13, 268, 20, 27});
-    mAnimation.addTextureRect({60, 266, 37, 29});
-    mAnimation.addTextureRect({102, 274, 32, 21});
-    mAnimation.addTextureRect({152, 273, 31, 22});
+    mAnimation.reset();
 
-    player->mCollisionRect =  player->mScaleFactor * sf::FloatRect(-10, -15, 20, 30);
+    player->mCollisionRect =  player->mScaleFactor * kUprightRect;
     if (player->mIsFacedRight)
         player->mSwordCollisionRect = player->mScaleFactor * sf::FloatRect(-15, -15, 45, 30);
     else
         player->mSwordCollisionRect = player->mScaleFactor * sf::FloatRect(-30, -15, 45, 30);
     mCurrentTime = kAttackTime;
-    
-    cout << "Creating Second Attack state" << endl;
+    thirdAttackTriggered = false;
+
+    log("Second Attack");
 }
 
 
@@ -569,7 +690,7 @@ void SecondAttack::hook(Player* player)
 {  
 }
 
-void SecondAttack::update(Player* player, float dt)
+void SecondAttack::update(Player* player, float dt, const InputState& input)
 {
     mAnimation.update(dt);
     player->mVelocity.x *= kVelocityDecay;
@@ -577,29 +698,29 @@ void SecondAttack::update(Player* player, float dt)
     if (mCurrentTime < 0 && player->mIsColliding)
     {
         if (thirdAttackTriggered)
-            player->setState(new ThirdAttack(player));
-        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) || sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+            setState<ThirdAttack>(player);
+        else if (input.isKeyPressed(sf::Keyboard::Left) || input.isKeyPressed(sf::Keyboard::Right))
         {
-            player->setState(new Running(player));
+            setState<Running>(player);
             player->mSwordCollisionRect = sf::FloatRect(0, 0, 0, 0);
         }
         else
         {
-            player->setState(new Idle(player));
+            setState<Idle>(player);
             player->mSwordCollisionRect = sf::FloatRect(0, 0, 0, 0);
         }
         return;
     }
 }
 
-void SecondAttack::handleEvents(Player* player, const sf::Event& event) 
+void SecondAttack::handleEvents(Player* player, const sf::Event& event, const InputState& input) 
 {
     if (event.type == sf::Event::KeyPressed)
     {
         if (event.key.code == sf::Keyboard::Space && player->mIsColliding)
         {
             jump(player);
-            player->setState(new Falling(player));
+            setState<Falling>(player);
             player->mSwordCollisionRect = sf::FloatRect(0, 0, 0, 0);
         }
         else if (event.key.code == sf::Keyboard::X) {
@@ -618,28 +739,23 @@ void SecondAttack::hitGround(Player* player)
 }
 
 
-ThirdAttack::ThirdAttack(Player* player) 
+ThirdAttack::ThirdAttack()
 {
-    mAnimation = Animation(Animation::AnimationType::OneIteration);
-    mAnimation.setAnimationSpeed(14);
- 
-    mAnimation.addTextureRect({152, 273, 31, 22});
-    mAnimation.addTextureRect({219, 269, 20, 26});
-    mAnimation.addTextureRect({270, 269, 20, 26});
-    mAnimation.addTextureRect({302, 272, 48, 23});
+    mAnimation = Animation(kThirdAttackClip);
+}
 
-    mAnimation.addTextureRect({3, 313, 31, 19});
-    mAnimation.addTextureRect({50, 312, 34, 20});
-    mAnimation.addTextureRect({100, 312, 34, 20});
+void ThirdAttack::enter(Player* player)
+{
+    mAnimation.reset();
 
-    player->mCollisionRect =  player->mScaleFactor * sf::FloatRect(-10, -15, 20, 30);
+    player->mCollisionRect =  player->mScaleFactor * kUprightRect;
     if (player->mIsFacedRight)
         player->mSwordCollisionRect = player->mScaleFactor * sf::FloatRect(-23, -15, 65, 30);
     else
         player->mSwordCollisionRect = player->mScaleFactor * sf::FloatRect(-37, -15, 65, 30);
     mCurrentTime = kAttackTime;
-    
-    cout << "Creating Third Attack state" << endl;
+
+    log("Third Attack");
 }
 
 
@@ -647,7 +763,7 @@ void ThirdAttack::hook(Player* player)
 {  
 }
 
-void ThirdAttack::update(Player* player, float dt)
+void ThirdAttack::update(Player* player, float dt, const InputState& input)
 {
     mAnimation.update(dt);
     player->mVelocity.x *= kVelocityDecay;
@@ -655,15 +771,15 @@ void ThirdAttack::update(Player* player, float dt)
     if (mCurrentTime < 0 && player->mIsColliding)
     {
         player->mSwordCollisionRect = sf::FloatRect(0, 0, 0, 0);
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) || sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
-            player->setState(new Running(player));
+        if (input.isKeyPressed(sf::Keyboard::Left) || input.isKeyPressed(sf::Keyboard::Right))
+            setState<Running>(player);
         else
-            player->setState(new Idle(player));
+            setState<Idle>(player);
         return;
     }
 }
 
-void ThirdAttack::handleEvents(Player* player, const sf::Event& event) 
+void ThirdAttack::handleEvents(Player* player, const sf::Event& event, const InputState& input) 
 {
     if (event.type == sf::Event::KeyPressed)
     {
@@ -671,7 +787,7 @@ void ThirdAttack::handleEvents(Player* player, const sf::Event& event)
         {
             player->mSwordCollisionRect = sf::FloatRect(0, 0, 0, 0);
             jump(player);
-            player->setState(new Falling(player));
+            setState<Falling>(player);
         }
     }
 }
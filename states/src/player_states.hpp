@@ -2,7 +2,10 @@
 
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <tuple>
 #include "animation.hpp"
+#include "input_state.hpp"
 #include "player.hpp"
 
 class Player;
@@ -11,9 +14,11 @@ class PlayerState
 {
 public:
     PlayerState();
-    
-    virtual void update(Player* player, float dt) = 0;
-    virtual void handleEvents(Player* player, const sf::Event& event) = 0;
+
+    // Called every time the player switches to this state
+    virtual void enter(Player* player) = 0;
+    virtual void update(Player* player, float dt, const InputState& input) = 0;
+    virtual void handleEvents(Player* player, const sf::Event& event, const InputState& input) = 0;
     virtual void hook(Player* player) = 0;
     virtual void startFalling(Player* player) = 0;
     virtual void hitGround(Player* player) = 0;
@@ -21,9 +26,19 @@ public:
 
     void updateSprite(sf::Sprite& sprite, bool isFacedRight, float scaleFactor);
 
+    // Prints every state the player enters
+    inline static bool sIsLoggingEnabled {false};
+
+    // Collision rect of the upright states, before the player's scale factor
+    inline static const sf::FloatRect kUprightRect {-10, -15, 20, 30};
+
 protected:
     Animation mAnimation;
 
+    template<class State>
+    static void setState(Player* player);
+    void log(const char* stateName) const;
+
     static constexpr float kJumpingVelocity = 1500;
     void jump(Player* player);
 };
@@ -32,10 +47,12 @@ protected:
 class Idle : public PlayerState
 {
 public:
-    Idle(Player* player);
+    Idle();
+
+    void enter(Player* player);
     
-    void update(Player* player, float dt);
-    void handleEvents(Player* player, const sf::Event& event);
+    void update(Player* player, float dt, const InputState& input);
+    void handleEvents(Player* player, const sf::Event& event, const InputState& input);
     void hook(Player* player);
     void startFalling(Player* player);
     void hitGround(Player* player);
@@ -47,15 +64,16 @@ private:
 class Running : public PlayerState
 {
 public:
-    Running(Player* player);
-    void update(Player* player, float dt);
-    void handleEvents(Player* player, const sf::Event& event);
+    static constexpr float kRunningSpeed = 900;
+
+    Running();
+
+    void enter(Player* player);
+    void update(Player* player, float dt, const InputState& input);
+    void handleEvents(Player* player, const sf::Event& event, const InputState& input);
     void hook(Player* player);
     void startFalling(Player* player);
     void hitGround(Player* player);
-
-private:
-    float mRunningSpeed;
 };
 
 
@@ -64,9 +82,11 @@ class Sliding : public PlayerState
 
 public:
 
-    Sliding(Player* player);
-    void update(Player* player, float dt);
-    void handleEvents(Player* player, const sf::Event& event);
+    Sliding();
+
+    void enter(Player* player);
+    void update(Player* player, float dt, const InputState& input);
+    void handleEvents(Player* player, const sf::Event& event, const InputState& input);
     void hook(Player* player);
     void startFalling(Player* player);
     void hitGround(Player* player);
@@ -83,16 +103,19 @@ private:
 class Falling : public PlayerState
 {
 public:
-    Falling(Player* player);
-    void update(Player* player, float dt);
-    void handleEvents(Player* player, const sf::Event& event);
+    static constexpr float kHorizontalVelocity = 800;
+
+    Falling();
+
+    void enter(Player* player);
+    void update(Player* player, float dt, const InputState& input);
+    void handleEvents(Player* player, const sf::Event& event, const InputState& input);
     void hook(Player* player);
     void startFalling(Player* player);
     void hitGround(Player* player);
 
 private:
 
-    static constexpr float kHorizontalVelocity = 800;
     bool mHasJumped = true;
     int mSpacePressedFrames = 0;
 };
@@ -105,9 +128,11 @@ public:
 
     static constexpr float kMaxHookOffset = 15;
 
-    Hooked(Player* player);
-    void update(Player* player, float dt);
-    void handleEvents(Player* player, const sf::Event& event);
+    Hooked();
+
+    void enter(Player* player);
+    void update(Player* player, float dt, const InputState& input);
+    void handleEvents(Player* player, const sf::Event& event, const InputState& input);
     void hook(Player* player);
     void startFalling(Player* player);
     void hitGround(Player* player);
@@ -118,10 +143,12 @@ public:
 class Sitting : public PlayerState
 {
 public:
-    Sitting(Player* player);
+    Sitting();
+
+    void enter(Player* player);
     
-    void update(Player* player, float dt);
-    void handleEvents(Player* player, const sf::Event& event);
+    void update(Player* player, float dt, const InputState& input);
+    void handleEvents(Player* player, const sf::Event& event, const InputState& input);
     void hook(Player* player);
     void startFalling(Player* player);
     void hitGround(Player* player);
@@ -134,10 +161,12 @@ private:
 class FirstAttack : public PlayerState
 {
 public:
-    FirstAttack(Player* player);
+    FirstAttack();
+
+    void enter(Player* player);
     
-    void update(Player* player, float dt);
-    void handleEvents(Player* player, const sf::Event& event);
+    void update(Player* player, float dt, const InputState& input);
+    void handleEvents(Player* player, const sf::Event& event, const InputState& input);
     void hook(Player* player);
     void startFalling(Player* player);
     void hitGround(Player* player);
@@ -152,10 +181,12 @@ private:
 class SecondAttack : public PlayerState
 {
 public:
-    SecondAttack(Player* player);
+    SecondAttack();
+
+    void enter(Player* player);
     
-    void update(Player* player, float dt);
-    void handleEvents(Player* player, const sf::Event& event);
+    void update(Player* player, float dt, const InputState& input);
+    void handleEvents(Player* player, const sf::Event& event, const InputState& input);
     void hook(Player* player);
     void startFalling(Player* player);
     void hitGround(Player* player);
@@ -171,10 +202,12 @@ private:
 class ThirdAttack : public PlayerState
 {
 public:
-    ThirdAttack(Player* player);
+    ThirdAttack();
+
+    void enter(Player* player);
     
-    void update(Player* player, float dt);
-    void handleEvents(Player* player, const sf::Event& event);
+    void update(Player* player, float dt, const InputState& input);
+    void handleEvents(Player* player, const sf::Event& event, const InputState& input);
     void hook(Player* player);
     void startFalling(Player* player);
     void hitGround(Player* player);
@@ -183,4 +216,42 @@ private:
     float mCurrentTime;
     static constexpr float kVelocityDecay = 0.92;
     static constexpr float kAttackTime = 0.5;
-};
\ No newline at end of file
+};
+
+
+
+// Number of every state, in the order of PlayerStates, for code that keeps states
+// as plain data instead of objects (see agent_store.hpp)
+enum class PlayerStateId : std::uint8_t
+{
+    Idle,
+    Running,
+    Sliding,
+    Falling,
+    Hooked,
+    Sitting,
+    FirstAttack,
+    SecondAttack,
+    ThirdAttack
+};
+
+// The clip the state plays
+const AnimationClip& getAnimationClip(PlayerStateId state);
+
+
+// One instance of every state, built together with the player.
+// Transitions only switch between them, so they never allocate.
+class PlayerStates
+{
+public:
+
+    template<class State>
+    State& get()
+    {
+        return std::get<State>(mStates);
+    }
+
+private:
+
+    std::tuple<Idle, Running, Sliding, Falling, Hooked, Sitting, FirstAttack, SecondAttack, ThirdAttack> mStates {};
+};
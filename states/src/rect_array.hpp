@@ -0,0 +1,57 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+
+// Rects stored as structure of arrays: all lefts together, all tops together and so on,
+// so batch tests can load several rects with one instruction (see overlap_kernel.hpp).
+// Only the benchmark uses it: World finds the few enemies near the sword through its grid,
+// and keeps them as plain rects.
+class RectArray
+{
+public:
+
+    void push_back(const sf::FloatRect& rect)
+    {
+        mLeft.push_back(rect.left);
+        mTop.push_back(rect.top);
+        mWidth.push_back(rect.width);
+        mHeight.push_back(rect.height);
+    }
+
+    void clear()
+    {
+        mLeft.clear();
+        mTop.clear();
+        mWidth.clear();
+        mHeight.clear();
+    }
+
+    sf::FloatRect operator[](size_t i) const
+    {
+        return {mLeft[i], mTop[i], mWidth[i], mHeight[i]};
+    }
+
+    size_t size() const
+    {
+        return mLeft.size();
+    }
+
+    bool empty() const
+    {
+        return mLeft.empty();
+    }
+
+    const float* left() const   { return mLeft.data(); }
+    const float* top() const    { return mTop.data(); }
+    const float* width() const  { return mWidth.data(); }
+    const float* height() const { return mHeight.data(); }
+
+private:
+
+    std::vector<float> mLeft    {};
+    std::vector<float> mTop     {};
+    std::vector<float> mWidth   {};
+    std::vector<float> mHeight  {};
+};
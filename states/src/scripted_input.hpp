@@ -0,0 +1,84 @@
+#pragma once
+
+#include <SFML/Window.hpp>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "input_source.hpp"
+
+
+// Key events scheduled on simulation ticks, stands in for a player at the keyboard
+class ScriptedInput : public InputSource
+{
+public:
+
+    // Events on the same tick are delivered in the order they were added
+    void addEvent(size_t tick, sf::Event::EventType type, sf::Keyboard::Key key)
+    {
+        sf::Event event;
+        event.type = type;
+        event.key = {key, false, false, false, false};
+        auto position = std::upper_bound(mEvents.begin() + mNext, mEvents.end(), tick,
+            [](size_t t, const ScheduledEvent& scheduled) { return t < scheduled.tick; });
+        mEvents.insert(position, {tick, event});
+    }
+
+    void addKeyPress(size_t tick, size_t duration, sf::Keyboard::Key key)
+    {
+        addEvent(tick, sf::Event::KeyPressed, key);
+        addEvent(tick + duration, sf::Event::KeyReleased, key);
+    }
+
+    // Every call moves on by one tick; once the script is over, ticks are empty
+    void nextFrame(InputFrame& frame) override
+    {
+        frame.events.clear();
+        while (mNext < mEvents.size() && mEvents[mNext].tick <= mTick)
+            frame.events.push_back(mEvents[mNext++].event);
+        mTick++;
+    }
+
+    // Somebody running around, jumping, sliding and attacking, the same for the same seed
+    static ScriptedInput makeRandomPlay(size_t ticks, unsigned seed)
+    {
+        ScriptedInput input;
+        std::mt19937 random(seed);
+        for (size_t tick = random() % 30; tick < ticks; tick += 5 + random() % 30)
+        {
+            switch (random() % 6)
+            {
+                case 0:
+                    input.addKeyPress(tick, 20 + random() % 100, sf::Keyboard::Left);
+                    break;
+                case 1:
+                    input.addKeyPress(tick, 20 + random() % 100, sf::Keyboard::Right);
+                    break;
+                case 2:
+                    input.addKeyPress(tick, 1 + random() % 10, sf::Keyboard::Space);
+                    break;
+                case 3:
+                    input.addKeyPress(tick, 1 + random() % 3, sf::Keyboard::X);
+                    break;
+                case 4:
+                    input.addKeyPress(tick, 5 + random() % 25, sf::Keyboard::LShift);
+                    break;
+                case 5:
+                    input.addKeyPress(tick, 1 + random() % 5, sf::Keyboard::Down);
+                    break;
+            }
+        }
+        return input;
+    }
+
+private:
+
+    struct ScheduledEvent
+    {
+        size_t tick;
+        sf::Event event;
+    };
+
+    std::vector<ScheduledEvent> mEvents     {};
+    size_t mNext                            {0};
+    size_t mTick                            {0};
+};
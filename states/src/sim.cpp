@@ -0,0 +1,73 @@
+// Headless load test: many independent Worlds, each playing the window's level from its own
+// scripted input, stepped at a fixed timestep as fast as the machine allows.
+//     make sim && ./sim --worlds=10000 --ticks=600 --threads=8
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "level.hpp"
+#include "simulation.hpp"
+
+using std::cout, std::endl;
+
+
+static size_t readOption(int argc, char** argv, const std::string& name, size_t defaultValue)
+{
+    std::string prefix = "--" + name + "=";
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg.compare(0, prefix.size(), prefix) == 0)
+            return std::stoul(arg.substr(prefix.size()));
+    }
+    return defaultValue;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t worldCount = readOption(argc, argv, "worlds", 10000);
+    const size_t tickCount = readOption(argc, argv, "ticks", 600);
+    const size_t threadCount = std::max<size_t>(1, readOption(argc, argv, "threads", std::thread::hardware_concurrency()));
+    const double tickTime = 1.0 / 60;
+
+    // every thread owns a contiguous range of worlds and ticks all of them, one tick at a time
+    std::vector<std::deque<Simulation>> simulations(threadCount);
+    auto setupStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < worldCount; i++)
+    {
+        Simulation& simulation = simulations[i * threadCount / worldCount].emplace_back(
+            ScriptedInput::makeRandomPlay(tickCount, static_cast<unsigned>(i)), tickTime);
+        buildLevel(simulation.getWorld());
+    }
+    double setupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - setupStart).count();
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::deque<Simulation>& group : simulations)
+    {
+        threads.emplace_back([&group, tickCount]()
+        {
+            for (size_t tick = 0; tick < tickCount; tick++)
+                for (Simulation& simulation : group)
+                    simulation.step();
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double ticksPerSecond = worldCount * tickCount / seconds;
+    cout << worldCount << " worlds x " << tickCount << " ticks on " << threadCount << " threads" << endl;
+    cout << std::fixed << std::setprecision(2)
+         << "  setup:     " << setupSeconds << " s" << endl
+         << "  simulated: " << seconds << " s" << endl
+         << std::setprecision(0)
+         << "  " << ticksPerSecond << " ticks/s, " << ticksPerSecond / threadCount << " ticks/s per thread" << endl
+         << "  " << ticksPerSecond * tickTime << " worlds can run in real time at " << 1 / tickTime << " Hz" << endl;
+    return 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <utility>
+#include "world.hpp"
+#include "fixed_timestep.hpp"
+#include "scripted_input.hpp"
+
+
+// A World without graphics driven by scripted input at a fixed timestep
+class Simulation
+{
+public:
+
+    Simulation(ScriptedInput input, double tickTime = 1.0 / 60) : mWorld{false}, mInput{std::move(input)}, mTimestep{tickTime}
+    {
+    }
+
+    World& getWorld()
+    {
+        return mWorld;
+    }
+
+    size_t getTickCount() const
+    {
+        return mTick;
+    }
+
+    // Runs one tick with the scripted input due on it
+    void step()
+    {
+        mInput.nextFrame(mFrame);
+        mWorld.update(mTimestep.getTickTime(), mFrame);
+        mTick++;
+    }
+
+    // Runs as many ticks as fit into the real time that has passed, for running at wall-clock speed
+    void advance(double elapsed)
+    {
+        int ticks = mTimestep.advance(elapsed);
+        for (int i = 0; i < ticks; i++)
+            step();
+    }
+
+private:
+
+    World mWorld;
+    ScriptedInput mInput;
+    InputFrame mFrame {};
+    FixedTimestep mTimestep;
+    size_t mTick {0};
+};
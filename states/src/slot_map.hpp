@@ -0,0 +1,128 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+
+// Stable reference to an entry of a RectSlotMap. It stays valid while the entry
+// lives and is recognized as stale afterwards, even if the slot gets reused.
+struct Handle
+{
+    std::uint32_t index         {0};
+    std::uint32_t generation    {0};
+
+    bool operator==(const Handle& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const Handle& other) const
+    {
+        return !(*this == other);
+    }
+
+    bool operator<(const Handle& other) const
+    {
+        return index < other.index || (index == other.index && generation < other.generation);
+    }
+};
+
+
+// Rects addressed by generational handles.
+// The rects themselves are kept dense, so iterating them never skips holes;
+// removal moves the last rect into the hole (O(1)).
+// Each handle goes through a slot that knows where its rect currently is.
+class RectSlotMap
+{
+public:
+
+    Handle insert(const sf::FloatRect& rect)
+    {
+        std::uint32_t slot;
+        if (!mFreeSlots.empty())
+        {
+            slot = mFreeSlots.back();
+            mFreeSlots.pop_back();
+        }
+        else
+        {
+            slot = static_cast<std::uint32_t>(mSlots.size());
+            mSlots.push_back({});
+        }
+
+        mSlots[slot].denseIndex = static_cast<std::uint32_t>(mDense.size());
+        mDense.push_back(rect);
+        mDenseToSlot.push_back(slot);
+        return {slot, mSlots[slot].generation};
+    }
+
+    bool contains(Handle handle) const
+    {
+        return handle.index < mSlots.size() && mSlots[handle.index].generation == handle.generation
+            && mSlots[handle.index].denseIndex != kFree;
+    }
+
+    // Does nothing for stale handles
+    void remove(Handle handle)
+    {
+        if (!contains(handle))
+            return;
+
+        Slot& slot = mSlots[handle.index];
+        std::uint32_t hole = slot.denseIndex;
+        std::uint32_t moved = mDenseToSlot.back();
+
+        mDense[hole] = mDense.back();
+        mDense.pop_back();
+        mDenseToSlot[hole] = moved;
+        mDenseToSlot.pop_back();
+        mSlots[moved].denseIndex = hole;
+
+        slot.denseIndex = kFree;
+        slot.generation++;
+        mFreeSlots.push_back(handle.index);
+    }
+
+    sf::FloatRect get(Handle handle) const
+    {
+        return mDense[mSlots[handle.index].denseIndex];
+    }
+
+    // Dense access: index i goes from 0 to size() - 1, the order changes on removal
+    const std::vector<sf::FloatRect>& rects() const
+    {
+        return mDense;
+    }
+
+    Handle handleAt(size_t i) const
+    {
+        std::uint32_t slot = mDenseToSlot[i];
+        return {slot, mSlots[slot].generation};
+    }
+
+    size_t size() const
+    {
+        return mDense.size();
+    }
+
+    bool empty() const
+    {
+        return mDense.empty();
+    }
+
+private:
+
+    static constexpr std::uint32_t kFree = 0xFFFFFFFF;
+
+    struct Slot
+    {
+        std::uint32_t denseIndex    {kFree};
+        std::uint32_t generation    {0};
+    };
+
+    std::vector<sf::FloatRect> mDense       {};
+    std::vector<std::uint32_t> mDenseToSlot {};
+    std::vector<Slot> mSlots                {};
+    std::vector<std::uint32_t> mFreeSlots   {};
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+
+// Uniform grid broadphase. Every object is registered in all cells its rect touches,
+// so a query only has to look at the cells around the area it's interested in.
+// Cell bounds are inclusive: rects that merely touch always share a cell.
+// Cells are hashed, so the world has no fixed size.
+template<class Id>
+class SpatialGrid
+{
+public:
+
+    explicit SpatialGrid(float cellSize = 256) : mCellSize{cellSize}
+    {
+    }
+
+    void insert(Id id, const sf::FloatRect& rect)
+    {
+        forEachCell(rect, [&](std::uint64_t key)
+        {
+            mCells[key].push_back(id);
+        });
+    }
+
+    void remove(Id id, const sf::FloatRect& rect)
+    {
+        forEachCell(rect, [&](std::uint64_t key)
+        {
+            auto cell = mCells.find(key);
+            if (cell == mCells.end())
+                return;
+            std::vector<Id>& ids = cell->second;
+            auto it = std::find(ids.begin(), ids.end(), id);
+            if (it != ids.end())
+            {
+                *it = ids.back();
+                ids.pop_back();
+            }
+        });
+    }
+
+    // Appends ids of everything registered near area to result, sorted and without duplicates
+    void query(const sf::FloatRect& area, std::vector<Id>& result) const
+    {
+        size_t first = result.size();
+        forEachCell(area, [&](std::uint64_t key)
+        {
+            auto cell = mCells.find(key);
+            if (cell != mCells.end())
+                result.insert(result.end(), cell->second.begin(), cell->second.end());
+        });
+        std::sort(result.begin() + first, result.end());
+        result.erase(std::unique(result.begin() + first, result.end()), result.end());
+    }
+
+    void clear()
+    {
+        mCells.clear();
+    }
+
+private:
+
+    template<class Function>
+    void forEachCell(const sf::FloatRect& rect, Function function) const
+    {
+        int x1 = cellCoord(rect.left);
+        int x2 = cellCoord(rect.left + rect.width);
+        int y1 = cellCoord(rect.top);
+        int y2 = cellCoord(rect.top + rect.height);
+        for (int x = x1; x <= x2; x++)
+            for (int y = y1; y <= y2; y++)
+                function(cellKey(x, y));
+    }
+
+    int cellCoord(float coord) const
+    {
+        return static_cast<int>(std::floor(coord / mCellSize));
+    }
+
+    static std::uint64_t cellKey(int x, int y)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+    }
+
+    float mCellSize;
+    std::unordered_map<std::uint64_t, std::vector<Id>> mCells {};
+};
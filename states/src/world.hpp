@@ -4,8 +4,14 @@
 #include <SFML/Graphics.hpp>
 #include <iostream>
 #include <cmath>
+#include <chrono>
 #include "player.hpp"
 #include "player_states.hpp"
+#include "input_state.hpp"
+#include "input_source.hpp"
+#include "spatial_grid.hpp"
+#include "aabb_tree.hpp"
+#include "slot_map.hpp"
 
 
 
@@ -14,14 +20,67 @@ class World
 {
 public:
 
+    // Collision resolution moves the player a bit, so look slightly beyond its rect
+    static constexpr float kCollisionMargin = 32;
+
+    // What the last frame drew for blocks and enemies
+    struct DrawStats
+    {
+        size_t drawCalls        {0};
+        size_t submittedRects   {0};    // sent to the GPU: exactly the rects overlapping the view
+        size_t levelRects       {0};    // all blocks and enemies in the level
+    };
+
+    // Without graphics nothing is loaded from disk. Drawing still works: the player has no
+    // texture then, so draw shows only the level and drawDebug the player's shapes
+    explicit World(bool withGraphics = true) : mPlayer{{400, 400}, withGraphics}
+    {
+    }
+
+    // Blocks are static: the tree and the vertices for them are rebuilt once, on the first frame after a change
     void addBlock(sf::FloatRect block)
     {
         mBlocks.push_back(block);
+        mIsBlockTreeOutdated = true;
+        mIsBlockVerticesOutdated = true;
+    }
+
+    // The handle stays valid until the enemy is killed or removed
+    Handle addEnemy(sf::FloatRect enemy)
+    {
+        Handle handle = mEnemies.insert(enemy);
+        mEnemyGrid.insert(handle, enemy);
+        return handle;
     }
 
-    void addEnemy(sf::FloatRect enemy)
+    void removeEnemy(Handle enemy)
     {
-        mEnemies.push_back(enemy);
+        if (!mEnemies.contains(enemy))
+            return;
+        mEnemyGrid.remove(enemy, mEnemies.get(enemy));
+        mEnemies.remove(enemy);
+    }
+
+    bool isEnemyAlive(Handle enemy) const
+    {
+        return mEnemies.contains(enemy);
+    }
+
+    sf::Vector2f getPlayerPosition() const
+    {
+        return mPlayer.getCenter();
+    }
+
+    // While profiling, update measures how long collision handling takes
+    void setProfiling(bool isProfiling)
+    {
+        mIsProfiling = isProfiling;
+    }
+
+    // Seconds spent on collisions during the last update, 0 when not profiling
+    double getCollisionTime() const
+    {
+        return mCollisionTime;
     }
 
     void setView()
@@ -43,57 +102,176 @@ public:
 
     }
 
-    void update(float dt)
-    {   
+    // Applies the tick's key events, then moves everything by dt
+    void update(float dt, const InputFrame& input)
+    {
+        for (const sf::Event& event : input.events)
+        {
+            mInput.handleEvent(event);
+            mPlayer.handleEvents(event, mInput);
+        }
+
         setView();
         mPlayer.applyVelocity({0, mGravity * dt});
-        mPlayer.update(dt);
-        mPlayer.handleAllCollisions(mBlocks, mEnemies);
-        std::vector<size_t> enemies_to_delete;
-        for (size_t i = 0; i < mEnemies.size(); i++)
+        mPlayer.update(dt, mInput);
+
+        std::chrono::steady_clock::time_point collisionStart;
+        if (mIsProfiling)
+            collisionStart = std::chrono::steady_clock::now();
+
+        updateBlockTree();
+        sf::FloatRect collisionArea = mPlayer.getCollisionRect();
+        collisionArea.left -= kCollisionMargin;
+        collisionArea.top -= kCollisionMargin;
+        collisionArea.width += 2 * kCollisionMargin;
+        collisionArea.height += 2 * kCollisionMargin;
+        mNearbyIds.clear();
+        mBlockTree.query(collisionArea, mNearbyIds);
+        gather(mBlocks, mNearbyBlocks);
+        mNearbyEnemyHandles.clear();
+        mEnemyGrid.query(collisionArea, mNearbyEnemyHandles);
+        mNearbyEnemies.clear();
+        for (Handle enemy : mNearbyEnemyHandles)
+            mNearbyEnemies.push_back(mEnemies.get(enemy));
+        mPlayer.handleAllCollisions(mNearbyBlocks, mNearbyEnemies);
+
+        // handles don't shift, so enemies can be removed right away
+        mNearbyEnemyHandles.clear();
+        mEnemyGrid.query(mPlayer.getSwordCollisionRect(), mNearbyEnemyHandles);
+        for (Handle enemy : mNearbyEnemyHandles)
         {
-            if (mPlayer.handleAttackCollision(mEnemies[i]))
-                enemies_to_delete.push_back(i);
+            if (mPlayer.handleAttackCollision(mEnemies.get(enemy)))
+                removeEnemy(enemy);
         }
-        for (const size_t& enemy_ind: enemies_to_delete) 
-            mEnemies.erase(mEnemies.begin() + enemy_ind);
+
+        if (mIsProfiling)
+            mCollisionTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - collisionStart).count();
     }
 
     void draw(sf::RenderWindow& window)
     {
-        static sf::RectangleShape blockShape;
+        window.setView(mView);
+        drawLevel(window);
+        mPlayer.draw(window);
+    }
 
+    // Debug shapes of everything in the world, on top of a normal draw
+    void drawDebug(sf::RenderWindow& window)
+    {
         window.setView(mView);
+        mPlayer.drawDebug(window);
+    }
 
-        for (const sf::FloatRect& b : mBlocks)
+    // Blocks and enemies only, culled against the window's current view: one batch for each
+    void drawLevel(sf::RenderWindow& window)
+    {
+        const sf::View& view = window.getView();
+        sf::FloatRect viewRect {view.getCenter() - view.getSize() / 2.f, view.getSize()};
+
+        // the tree finds visible blocks, their vertices are copied from the cached ones
+        updateBlockTree();
+        updateBlockVertices();
+        mNearbyIds.clear();
+        mBlockTree.query(viewRect, mNearbyIds);
+        mVisibleBlockVertices.clear();
+        for (size_t i : mNearbyIds)
         {
-            blockShape.setFillColor(sf::Color(58, 69, 55));
-            blockShape.setPosition(b.left, b.top);
-            blockShape.setSize({b.width, b.height});
-            window.draw(blockShape);
+            for (size_t v = 6 * i; v < 6 * i + 6; v++)
+                mVisibleBlockVertices.append(mBlockVertices[v]);
         }
-        for (const sf::FloatRect& e : mEnemies)
+
+        // the grid returns enemies from the cells around the view, keep those really in it
+        mNearbyEnemyHandles.clear();
+        mEnemyGrid.query(viewRect, mNearbyEnemyHandles);
+        mEnemyVertices.clear();
+        size_t visibleEnemies = 0;
+        for (Handle enemy : mNearbyEnemyHandles)
         {
-            blockShape.setFillColor(sf::Color(120, 55, 55));
-            blockShape.setPosition(e.left, e.top);
-            blockShape.setSize({e.width, e.height});
-            window.draw(blockShape);
+            sf::FloatRect rect = mEnemies.get(enemy);
+            if (!viewRect.intersects(rect))
+                continue;
+            appendRect(mEnemyVertices, rect, sEnemyColor);
+            visibleEnemies++;
         }
-        mPlayer.draw(window);
+
+        window.draw(mVisibleBlockVertices);
+        window.draw(mEnemyVertices);
+        mDrawStats.drawCalls = 2;
+        mDrawStats.submittedRects = mNearbyIds.size() + visibleEnemies;
+        mDrawStats.levelRects = mBlocks.size() + mEnemies.size();
     }
 
-    void handleEvents(const sf::Event& event)
+    const DrawStats& getDrawStats() const
     {
-        mPlayer.handleEvents(event);
+        return mDrawStats;
     }
 
+private:
 
+    void updateBlockTree()
+    {
+        if (!mIsBlockTreeOutdated)
+            return;
+        mBlockTree.build(mBlocks);
+        mIsBlockTreeOutdated = false;
+    }
+
+    void updateBlockVertices()
+    {
+        if (!mIsBlockVerticesOutdated)
+            return;
+        mBlockVertices.clear();
+        for (const sf::FloatRect& block : mBlocks)
+            appendRect(mBlockVertices, block, sBlockColor);
+        mIsBlockVerticesOutdated = false;
+    }
+
+    // Two triangles covering rect
+    static void appendRect(sf::VertexArray& vertices, const sf::FloatRect& rect, sf::Color color)
+    {
+        sf::Vector2f topLeft {rect.left, rect.top};
+        sf::Vector2f topRight {rect.left + rect.width, rect.top};
+        sf::Vector2f bottomLeft {rect.left, rect.top + rect.height};
+        sf::Vector2f bottomRight {rect.left + rect.width, rect.top + rect.height};
+        vertices.append({topLeft, color});
+        vertices.append({topRight, color});
+        vertices.append({bottomRight, color});
+        vertices.append({topLeft, color});
+        vertices.append({bottomRight, color});
+        vertices.append({bottomLeft, color});
+    }
+
+    // Copies rects listed in mNearbyIds into out
+    void gather(const std::vector<sf::FloatRect>& rects, std::vector<sf::FloatRect>& out)
+    {
+        out.clear();
+        for (size_t i : mNearbyIds)
+            out.push_back(rects[i]);
+    }
 
-private:
     std::vector<sf::FloatRect> mBlocks  {};
-    std::vector<sf::FloatRect> mEnemies {};
-    Player mPlayer                      {{400, 400}};
+    RectSlotMap mEnemies                {};
+    StaticAabbTree mBlockTree           {};
+    bool mIsBlockTreeOutdated           {false};
+    SpatialGrid<Handle> mEnemyGrid      {};
+
+    inline static sf::Color sBlockColor {58, 69, 55};
+    inline static sf::Color sEnemyColor {120, 55, 55};
+    sf::VertexArray mBlockVertices          {sf::Triangles};    // all blocks, 6 vertices each, in mBlocks order
+    sf::VertexArray mVisibleBlockVertices   {sf::Triangles};
+    sf::VertexArray mEnemyVertices          {sf::Triangles};
+    bool mIsBlockVerticesOutdated           {false};
+    DrawStats mDrawStats                    {};
+
+    std::vector<size_t> mNearbyIds              {};
+    std::vector<Handle> mNearbyEnemyHandles     {};
+    std::vector<sf::FloatRect> mNearbyBlocks    {};
+    std::vector<sf::FloatRect> mNearbyEnemies   {};
+    InputState mInput                   {};
+    Player mPlayer;
     float mGravity                      {3600};
+    bool mIsProfiling                   {false};
+    double mCollisionTime               {0};
 
     sf::View mView                      {sf::FloatRect(0, 0, 1200, 900)};
 };
\ No newline at end of file